@@ -81,17 +81,6 @@ int clockCenterX = screenW / 2;
 int clockCenterY = ((screenH - 16) / 2) + 16; // top yellow part is 16 px height
 int clockRadius = 23;
 
-// utility function for digital clock display: prints leading 0
-String twoDigits(int digits) {
-  if (digits < 10) {
-    String i = '0' + String(digits);
-    return i;
-  }
-  else {
-    return String(digits);
-  }
-}
-
 void clockOverlay(OLEDDisplay *display, OLEDDisplayUiState* state) {
 
 }
@@ -138,10 +127,15 @@ void analogClockFrame(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x
 }
 
 void digitalClockFrame(OLEDDisplay *display, OLEDDisplayUiState* state, int16_t x, int16_t y) {
-  String timenow = String(hour()) + ":" + twoDigits(minute()) + ":" + twoDigits(second());
-  display->setTextAlignment(TEXT_ALIGN_CENTER);
+  display->setTextAlignment(TEXT_ALIGN_LEFT);
   display->setFont(ArialMT_Plain_24);
-  display->drawString(clockCenterX + x , clockCenterY + y, timenow );
+  // The digits of a font are equally wide, no need to build the string to center it
+  int16_t cursorX = clockCenterX + x - display->getStringWidth(hour() < 10 ? "0:00:00" : "00:00:00") / 2;
+  // h:mm is a fixed point number with a colon as the point
+  cursorX += display->drawFixed(cursorX, clockCenterY + y, hour() * 100 + minute(), 2, ':');
+  display->drawString(cursorX, clockCenterY + y, ":");
+  cursorX += display->getStringWidth(":");
+  display->drawNumber(cursorX, clockCenterY + y, second(), 2);
 }
 
 // This array keeps function pointers to all frames
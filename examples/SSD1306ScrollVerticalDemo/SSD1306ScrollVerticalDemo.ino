@@ -68,24 +68,28 @@ const String loremipsum = "Lorem ipsum dolor sit ämet, "
   "takimata sanctus est Lorem ipsum dolor sit amet. "
   "äöü-ÄÖÜ/ß€é/çØ.";
 
+// The text wrapped once, each frame only draws the lines on the screen
+OLEDDisplayTextLayout layout;
+
 void setup() {
   display.init();
   display.setContrast(255);
   display.setTextAlignment(TEXT_ALIGN_LEFT);
   display.setFont(ArialMT_Plain_16);
+  display.layoutText(&layout, loremipsum, 128);
   display.display();
 }
 
 void loop() {
-  static uint16_t start_at = 0;
+  static uint32_t scrollY = 0;
   display.clear();
-  uint16_t firstline = display.drawStringMaxWidth(0, 0, 128, loremipsum.substring(start_at));
+  display.drawTextLayout(0, 0, &layout, scrollY);
   display.display();
-  if (firstline != 0) {
-    start_at += firstline;
+  if (scrollY + display.getHeight() < layout.getHeight()) {
+    scrollY++;
   } else {
-    start_at = 0;
+    scrollY = 0;
     delay(1000); // additional pause before going back to start
   }
-  delay(1000);
+  delay(scrollY % layout.lineHeight == 0 ? 1000 : 20); // stop at every line
 }
@@ -31,6 +31,7 @@
 // For a connection via I2C using Wire include
 #include <Wire.h>  // Only needed for Arduino 1.6.5 and earlier
 #include "SSD1306Wire.h" // legacy include: `#include "SSD1306.h"`
+#include "OLEDDisplayManager.h"
 #include "images.h"
 
 // Initialize the OLED display using Wire library
@@ -43,15 +44,20 @@
 SSD1306Wire  display(0x3c, 0, 14);
 SSD1306Wire  display2(0x3c, 5, 4);
 
+// Sends the changes of both displays, alternating between them page by page.
+// On ESP32 with the displays on I2C_ONE and I2C_TWO add display2 with bus 1,
+// both displays are then written at the same time.
+OLEDDisplayManager displays;
+
 void setup() {
   Serial.begin(115200);
   Serial.println();
   Serial.println();
 
 
-  // Initialising the UI will init the display too.
-  display.init();
-  display2.init();
+  displays.add(&display);
+  displays.add(&display2);
+  displays.init();
 
   // This will make sure that multiple instances of a display driver
   // running on different ports will work together transparently
@@ -71,11 +77,11 @@ void setup() {
 void loop() {
   display.clear();
   display.drawString(0, 0, "Hello world: " + String(millis()));
-  display.display();
 
   display2.clear();
   display2.drawString(0, 0, "Hello world: " + String(millis()));
-  display2.display();
+
+  displays.display();
 
   delay(10);
 }
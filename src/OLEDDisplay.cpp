@@ -41,15 +41,52 @@ OLEDDisplay::OLEDDisplay() {
 	displayWidth = 128;
 	displayHeight = 64;
 	displayBufferSize = displayWidth * displayHeight / 8;
+  logBufferSize = 0;
+  logBufferFilled = 0;
+  logBufferLine = 0;
+  logBufferMaxLines = 0;
+  logBuffer = NULL;
   inhibitDrawLogBuffer = false;
+  logBufferDirty = false;
+  logBufferRedrawInterval = 0;
+  logBufferLastRedraw = 0;
 	color = WHITE;
 	geometry = GEOMETRY_128_64;
+	scrolling = false;
+	bufferSwap = false;
+	frameStats = NULL;
+	traceSink = NULL;
+	frameDiffTime = 0;
+	frameTransferTime = 0;
+	frameDrawTime = 0;
+	frameEnd = 0;
+	frameTransactions = 0;
+	frameBusBytes = 0;
+	transferFrame = NULL;
+	transferMinX = 0;
+	transferMaxX = 0;
+	transferMinPage = 0;
+	transferMaxPage = 0;
+	transferPage = 1;
 	textAlignment = TEXT_ALIGN_LEFT;
+	textScale = 1;
 	fontData = ArialMT_Plain_10;
 	fontTableLookupFunction = DefaultFontTableLookup;
+	fontWidths = NULL;
+	fontWidthsValid = false;
+	digitGlyphsValid = false;
+	widthCache = NULL;
+	widthCacheSize = 0;
 	buffer = NULL;
-#ifdef OLEDDISPLAY_DOUBLE_BUFFER
 	buffer_back = NULL;
+	drawTarget = NULL;
+	drawTargetWidth = 0;
+	drawTargetHeight = 0;
+	drawTargetSize = 0;
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+	doubleBuffered = true;
+#else
+	doubleBuffered = false;
 #endif
 }
 
@@ -80,25 +117,30 @@ bool OLEDDisplay::allocateBuffer() {
     }
   }
 
-  #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-  if(this->buffer_back==NULL) {
+  if(this->doubleBuffered && this->buffer_back==NULL) {
     this->buffer_back = (uint8_t*) malloc((sizeof(uint8_t) * displayBufferSize) + BufferOffset);
     this->buffer_back += BufferOffset;
 
     if(!this->buffer_back) {
       DEBUG_OLEDDISPLAY("[OLEDDISPLAY][init] Not enough memory to create back buffer\n");
       free(this->buffer - BufferOffset);
+      this->buffer = NULL;
       return false;
     }
+  } else if (!this->doubleBuffered && this->buffer_back) {
+    free(this->buffer_back - BufferOffset);
+    this->buffer_back = NULL;
   }
-  #endif
 
   return true;
 }
 
-bool OLEDDisplay::init() {
+bool OLEDDisplay::init(OLEDDISPLAY_BUFFERING buffering) {
 
   BufferOffset = getBufferOffset();
+  if (buffering != BUFFERING_DEFAULT) {
+    doubleBuffered = buffering == BUFFERING_DOUBLE;
+  }
 
   if(!allocateBuffer()) {
     return false;
@@ -112,17 +154,17 @@ bool OLEDDisplay::init() {
 
 void OLEDDisplay::end() {
   if (this->buffer) { free(this->buffer - BufferOffset); this->buffer = NULL; }
-  #ifdef OLEDDISPLAY_DOUBLE_BUFFER
   if (this->buffer_back) { free(this->buffer_back - BufferOffset); this->buffer_back = NULL; }
-  #endif
   if (this->logBuffer != NULL) { free(this->logBuffer); this->logBuffer = NULL; }
+  if (this->fontWidths) { free(this->fontWidths); this->fontWidths = NULL; this->fontWidthsValid = false; }
+  setStringWidthCache(0);
 }
 
 void OLEDDisplay::resetDisplay(void) {
   clear();
-  #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-  memset(buffer_back, 1, displayBufferSize);
-  #endif
+  if (buffer_back) {
+    memset(buffer_back, 1, displayBufferSize);
+  }
   display();
 }
 
@@ -135,31 +177,31 @@ OLEDDISPLAY_COLOR OLEDDisplay::getColor() {
 }
 
 void OLEDDisplay::setPixel(int16_t x, int16_t y) {
-  if (x >= 0 && x < this->width() && y >= 0 && y < this->height()) {
+  if (x >= 0 && x < drawWidth() && y >= 0 && y < drawHeight()) {
     switch (color) {
-      case WHITE:   buffer[x + (y / 8) * this->width()] |=  (1 << (y & 7)); break;
-      case BLACK:   buffer[x + (y / 8) * this->width()] &= ~(1 << (y & 7)); break;
-      case INVERSE: buffer[x + (y / 8) * this->width()] ^=  (1 << (y & 7)); break;
+      case WHITE:   drawBuffer()[x + (y / 8) * drawWidth()] |=  (1 << (y & 7)); break;
+      case BLACK:   drawBuffer()[x + (y / 8) * drawWidth()] &= ~(1 << (y & 7)); break;
+      case INVERSE: drawBuffer()[x + (y / 8) * drawWidth()] ^=  (1 << (y & 7)); break;
     }
   }
 }
 
 void OLEDDisplay::setPixelColor(int16_t x, int16_t y, OLEDDISPLAY_COLOR color) {
-  if (x >= 0 && x < this->width() && y >= 0 && y < this->height()) {
+  if (x >= 0 && x < drawWidth() && y >= 0 && y < drawHeight()) {
     switch (color) {
-      case WHITE:   buffer[x + (y / 8) * this->width()] |=  (1 << (y & 7)); break;
-      case BLACK:   buffer[x + (y / 8) * this->width()] &= ~(1 << (y & 7)); break;
-      case INVERSE: buffer[x + (y / 8) * this->width()] ^=  (1 << (y & 7)); break;
+      case WHITE:   drawBuffer()[x + (y / 8) * drawWidth()] |=  (1 << (y & 7)); break;
+      case BLACK:   drawBuffer()[x + (y / 8) * drawWidth()] &= ~(1 << (y & 7)); break;
+      case INVERSE: drawBuffer()[x + (y / 8) * drawWidth()] ^=  (1 << (y & 7)); break;
     }
   }
 }
 
 void OLEDDisplay::clearPixel(int16_t x, int16_t y) {
-  if (x >= 0 && x < this->width() && y >= 0 && y < this->height()) {
+  if (x >= 0 && x < drawWidth() && y >= 0 && y < drawHeight()) {
     switch (color) {
-      case BLACK:   buffer[x + (y >> 3) * this->width()] |=  (1 << (y & 7)); break;
-      case WHITE:   buffer[x + (y >> 3) * this->width()] &= ~(1 << (y & 7)); break;
-      case INVERSE: buffer[x + (y >> 3) * this->width()] ^=  (1 << (y & 7)); break;
+      case BLACK:   drawBuffer()[x + (y >> 3) * drawWidth()] |=  (1 << (y & 7)); break;
+      case WHITE:   drawBuffer()[x + (y >> 3) * drawWidth()] &= ~(1 << (y & 7)); break;
+      case INVERSE: drawBuffer()[x + (y >> 3) * drawWidth()] ^=  (1 << (y & 7)); break;
     }
   }
 }
@@ -389,21 +431,21 @@ void OLEDDisplay::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
 }
 
 void OLEDDisplay::drawHorizontalLine(int16_t x, int16_t y, int16_t length) {
-  if (y < 0 || y >= this->height()) { return; }
+  if (y < 0 || y >= drawHeight()) { return; }
 
   if (x < 0) {
     length += x;
     x = 0;
   }
 
-  if ( (x + length) > this->width()) {
-    length = (this->width() - x);
+  if ( (x + length) > drawWidth()) {
+    length = (drawWidth() - x);
   }
 
   if (length <= 0) { return; }
 
-  uint8_t * bufferPtr = buffer;
-  bufferPtr += (y >> 3) * this->width();
+  uint8_t * bufferPtr = drawBuffer();
+  bufferPtr += (y >> 3) * drawWidth();
   bufferPtr += x;
 
   uint8_t drawBit = 1 << (y & 7);
@@ -422,15 +464,16 @@ void OLEDDisplay::drawHorizontalLine(int16_t x, int16_t y, int16_t length) {
 }
 
 void OLEDDisplay::drawVerticalLine(int16_t x, int16_t y, int16_t length) {
-  if (x < 0 || x >= this->width()) return;
+  uint16_t targetWidth = drawWidth();
+  if (x < 0 || x >= targetWidth) return;
 
   if (y < 0) {
     length += y;
     y = 0;
   }
 
-  if ( (y + length) > this->height()) {
-    length = (this->height() - y);
+  if ( (y + length) > drawHeight()) {
+    length = (drawHeight() - y);
   }
 
   if (length <= 0) return;
@@ -438,9 +481,9 @@ void OLEDDisplay::drawVerticalLine(int16_t x, int16_t y, int16_t length) {
 
   uint8_t yOffset = y & 7;
   uint8_t drawBit;
-  uint8_t *bufferPtr = buffer;
+  uint8_t *bufferPtr = drawBuffer();
 
-  bufferPtr += (y >> 3) * this->width();
+  bufferPtr += (y >> 3) * targetWidth;
   bufferPtr += x;
 
   if (yOffset) {
@@ -460,7 +503,7 @@ void OLEDDisplay::drawVerticalLine(int16_t x, int16_t y, int16_t length) {
     if (length < yOffset) return;
 
     length -= yOffset;
-    bufferPtr += this->width();
+    bufferPtr += targetWidth;
   }
 
   if (length >= 8) {
@@ -470,14 +513,14 @@ void OLEDDisplay::drawVerticalLine(int16_t x, int16_t y, int16_t length) {
         drawBit = (color == WHITE) ? 0xFF : 0x00;
         do {
           *bufferPtr = drawBit;
-          bufferPtr += this->width();
+          bufferPtr += targetWidth;
           length -= 8;
         } while (length >= 8);
         break;
       case INVERSE:
         do {
           *bufferPtr = ~(*bufferPtr);
-          bufferPtr += this->width();
+          bufferPtr += targetWidth;
           length -= 8;
         } while (length >= 8);
         break;
@@ -553,12 +596,73 @@ void OLEDDisplay::drawIco16x16(int16_t xMove, int16_t yMove, const uint8_t *ico,
   }
 }
 
-uint16_t OLEDDisplay::drawStringInternal(int16_t xMove, int16_t yMove, const char* text, uint16_t textLength, uint16_t textWidth, bool utf8) {
-  uint16_t textHeight       = pgm_read_word(fontData + HEIGHT_POS);
-  uint16_t firstChar        = pgm_read_word(fontData + FIRST_CHAR_POS);
-  uint16_t sizeOfJumpTable = pgm_read_word(fontData + CHAR_NUM_POS)  * JUMPTABLE_BYTES;
+void OLEDDisplay::drawPageBuffer(int16_t xMove, int16_t yMove, uint16_t width, uint16_t height, const uint8_t *pages) {
+  drawPageBuffer(xMove, yMove, width, height, pages, width, height, 0, 0);
+}
+
+void OLEDDisplay::drawPageBuffer(int16_t xMove, int16_t yMove, uint16_t width, uint16_t height, const uint8_t *pages,
+                                 uint16_t pagesWidth, uint16_t pagesHeight, uint16_t srcX, uint16_t srcY) {
+  if (srcX >= pagesWidth || srcY >= pagesHeight) return;
+  if (width  > pagesWidth  - srcX) width  = pagesWidth  - srcX;
+  if (height > pagesHeight - srcY) height = pagesHeight - srcY;
+  if (xMove >= drawWidth() || xMove + width <= 0) return;
+  if (yMove >= drawHeight() || yMove + height <= 0) return;
+
+  // Visible column and row range of the window
+  int16_t xStart = xMove < 0 ? -xMove : 0;
+  int16_t xEnd   = xMove + width > drawWidth() ? drawWidth() - xMove : width;
+  int16_t yStart = yMove < 0 ? 0 : yMove;
+  int16_t yEnd   = yMove + height > drawHeight() ? drawHeight() : yMove + height;
+
+  int16_t srcPages = (pagesHeight + 7) >> 3;
+
+  for (int16_t destPage = yStart >> 3; destPage <= (yEnd - 1) >> 3; destPage++) {
+    // Rows of this page within the window
+    int16_t top  = destPage << 3;
+    uint8_t mask = 0xFF;
+    if (yStart > top)    mask &= 0xFF << (yStart - top);
+    if (yEnd < top + 8)  mask &= 0xFF >> (top + 8 - yEnd);
+
+    // The rows of a display page come from (a part of) two source pages
+    int16_t srcRow  = top - yMove + srcY;
+    int16_t srcPage = srcRow >> 3;
+    uint8_t shift   = srcRow & 7;
+    const uint8_t *low  = srcPage >= 0 && srcPage < srcPages ? pages + srcPage * pagesWidth + srcX : NULL;
+    const uint8_t *high = shift && srcPage + 1 >= 0 && srcPage + 1 < srcPages ? pages + (srcPage + 1) * pagesWidth + srcX : NULL;
+
+    uint8_t *dest = drawBuffer() + destPage * drawWidth() + xMove;
+    for (int16_t x = xStart; x < xEnd; x++) {
+      uint8_t data = ((low ? low[x] >> shift : 0) | (high ? high[x] << (8 - shift) : 0)) & mask;
+      switch (color) {
+        case WHITE:   dest[x] |= data; break;
+        case BLACK:   dest[x] &= ~data; break;
+        case INVERSE: dest[x] ^= data; break;
+      }
+    }
+  }
+}
+
+void OLEDDisplay::setDrawTarget(uint8_t *pages, uint16_t width, uint16_t height) {
+  drawTarget       = pages;
+  drawTargetWidth  = pages ? width : 0;
+  drawTargetHeight = pages ? height : 0;
+  drawTargetSize   = pages ? width * ((height + 7) >> 3) : 0;
+}
 
-  uint16_t cursorX         = 0;
+uint16_t OLEDDisplay::drawStringInternal(int16_t xMove, int16_t yMove, const char* text, uint16_t textLength, uint16_t textWidth, bool utf8) {
+  uint16_t fontHeight       = pgm_read_word(fontData + HEIGHT_POS);
+  uint8_t  scale            = textScale;
+  uint16_t textHeight       = fontHeight * scale;
+  uint16_t jumpTableStart   = getJumpTableStart();
+  const uint16_t *charData  = getCharData();
+  const uint16_t *metrics   = getFontMetrics();
+  bool     compressed       = pgm_read_word(fontData + WIDTH_POS) & FONT_RLE;
+
+  uint16_t kerningCount    = 0;
+  const uint16_t *kerning  = getKerningPairs(&kerningCount);
+  int32_t  previousChar    = -1;
+
+  int16_t  cursorX         = 0;
   uint16_t cursorY         = 0;
   uint16_t charCount       = 0;
 
@@ -577,40 +681,57 @@ uint16_t OLEDDisplay::drawStringInternal(int16_t xMove, int16_t yMove, const cha
   }
 
   // Don't draw anything if it is not on the screen.
-  if (xMove + textWidth  < 0 || xMove >= this->width() ) {return 0;}
-  if (yMove + textHeight < 0 || yMove >= this->height()) {return 0;}
+  if (xMove + textWidth  < 0 || xMove >= drawWidth() ) {return 0;}
+  if (yMove + textHeight < 0 || yMove >= drawHeight()) {return 0;}
 
-  for (uint16_t j = 0; j < textLength; j++) {
+  uint16_t j = 0;
+  while (j < textLength) {
     int16_t xPos = xMove + cursorX;
     int16_t yPos = yMove + cursorY;
-    if (xPos > this->width())
+    if (xPos > drawWidth())
       break; // no need to continue
-    charCount++;
-
-    uint8_t code;
-    if (utf8) {
-      code = (this->fontTableLookupFunction)(text[j]);
-      if (code == 0)
-        continue;
-    } else
-      code = text[j];
-    if (code >= firstChar) {
-      uint8_t charCode = code - firstChar;
 
+    uint32_t code = (uint8_t) text[j];
+    if (utf8 && code >= 0x80) {
+      code = getFontCode(Utf8Decode(text, textLength, &j));
+    } else {
+      j++;
+    }
+    charCount = j;
+    if (code == 0)
+      continue;
+    int32_t charCode = getGlyphIndex(code);
+    if (charCode >= 0) {
       // 4 Bytes per char code
-      uint16_t msbJumpToChar    = pgm_read_word( fontData + JUMPTABLE_START + charCode * JUMPTABLE_BYTES );                  // MSB  \ JumpAddress
-      uint16_t lsbJumpToChar    = pgm_read_word( fontData + JUMPTABLE_START + charCode * JUMPTABLE_BYTES + JUMPTABLE_LSB);   // LSB /
-      uint16_t charByteSize     = pgm_read_word( fontData + JUMPTABLE_START + charCode * JUMPTABLE_BYTES + JUMPTABLE_SIZE);  // Size
-      uint16_t currentCharWidth = pgm_read_word( fontData + JUMPTABLE_START + charCode * JUMPTABLE_BYTES + JUMPTABLE_WIDTH); // Width
+      uint16_t msbJumpToChar    = pgm_read_word( fontData + jumpTableStart + charCode * JUMPTABLE_BYTES );                  // MSB  \ JumpAddress
+      uint16_t lsbJumpToChar    = pgm_read_word( fontData + jumpTableStart + charCode * JUMPTABLE_BYTES + JUMPTABLE_LSB);   // LSB /
+      uint16_t charByteSize     = pgm_read_word( fontData + jumpTableStart + charCode * JUMPTABLE_BYTES + JUMPTABLE_SIZE);  // Size
+      uint16_t currentCharWidth = pgm_read_word( fontData + jumpTableStart + charCode * JUMPTABLE_BYTES + JUMPTABLE_WIDTH); // Width
+      uint16_t advance          = currentCharWidth;
+
+      if (metrics) {
+        // The bitmap starts at the bearing, the kerning moves the whole char
+        uint16_t charMetrics = pgm_read_word(metrics + charCode);
+        advance = charMetrics & 0xFF;
+        if (kerning) cursorX += getKerning(kerning, kerningCount, previousChar, charCode) * scale;
+        xPos = xMove + cursorX + (int8_t) (charMetrics >> 8) * scale;
+        previousChar = charCode;
+      }
 
       // Test if the char is drawable
       if (!(msbJumpToChar == 255 && lsbJumpToChar == 255)) {
         // Get the position of the char data
-        uint16_t charDataPosition = JUMPTABLE_START + sizeOfJumpTable + ((msbJumpToChar << 8) + lsbJumpToChar);
-        drawInternal(xPos, yPos, currentCharWidth, textHeight, fontData, charDataPosition, charByteSize);
+        uint16_t charDataPosition = (msbJumpToChar << 8) + lsbJumpToChar;
+        if (scale > 1) {
+          drawInternalScaled(xPos, yPos, currentCharWidth, fontHeight, charData, charDataPosition, charByteSize, compressed, scale);
+        } else {
+          drawInternal(xPos, yPos, currentCharWidth, textHeight, charData, charDataPosition, charByteSize, compressed);
+        }
       }
 
-      cursorX += currentCharWidth;
+      cursorX += advance * scale;
+    } else {
+      previousChar = -1;
     }
   }
   return charCount;
@@ -618,7 +739,7 @@ uint16_t OLEDDisplay::drawStringInternal(int16_t xMove, int16_t yMove, const cha
 
 
 uint16_t OLEDDisplay::drawString(int16_t xMove, int16_t yMove, const String &strUser) {
-  uint16_t lineHeight = pgm_read_word(fontData + HEIGHT_POS);
+  uint16_t lineHeight = pgm_read_word(fontData + HEIGHT_POS) * textScale;
 
   // char* text must be freed!
   char* text = strdup(strUser.c_str());
@@ -645,7 +766,9 @@ uint16_t OLEDDisplay::drawString(int16_t xMove, int16_t yMove, const String &str
   char* textPart = strtok(text,"\n");
   while (textPart != NULL) {
     uint16_t length = strlen(textPart);
-    charDrawn += drawStringInternal(xMove, yMove - yOffset + (line++) * lineHeight, textPart, length, getStringWidth(textPart, length, true), true);
+    // Left aligned text on the screen doesn't need its width
+    uint16_t width = textAlignment == TEXT_ALIGN_LEFT && xMove >= 0 ? 0 : getStringWidth(textPart, length, true);
+    charDrawn += drawStringInternal(xMove, yMove - yOffset + (line++) * lineHeight, textPart, length, width, true);
     textPart = strtok(NULL, "\n");
   }
   free(text);
@@ -662,83 +785,508 @@ void OLEDDisplay::drawStringf( int16_t x, int16_t y, char* buffer, String format
 }
 
 uint16_t OLEDDisplay::drawStringMaxWidth(int16_t xMove, int16_t yMove, uint16_t maxLineWidth, const String &strUser) {
-  uint16_t firstChar  = pgm_read_word(fontData + FIRST_CHAR_POS);
-  uint16_t lineHeight = pgm_read_word(fontData + HEIGHT_POS);
+  uint16_t lineHeight = pgm_read_word(fontData + HEIGHT_POS) * textScale;
 
   const char* text = strUser.c_str();
 
   uint16_t length = strlen(text);
-  uint16_t lastDrawnPos = 0;
   uint16_t lineNumber = 0;
-  uint16_t strWidth = 0;
+  uint16_t firstLineChars = 0;
+  uint16_t drawStringResult = 1; // later tested for 0 == error, so initialize to 1
+
+  for (uint16_t start = 0; start < length;) {
+    uint16_t lineLength, lineWidth;
+    uint16_t next = start + getLineBreak(&text[start], length - start, maxLineWidth, &lineLength, &lineWidth);
+    int16_t lineY = yMove + lineNumber * lineHeight;
+    // Lines above the display are skipped, drawStringInternal() would report them as past it
+    if (lineLength > 0 && lineY + lineHeight >= 0)
+      drawStringResult = drawStringInternal(xMove, lineY, &text[start], lineLength, lineWidth, true);
+    if (lineNumber++ == 0 && next < length)
+      firstLineChars = next;
+    start = next;
+    if (drawStringResult == 0) // we are past the display already?
+      break;
+  }
 
+  if (drawStringResult == 0 || (yMove + lineNumber * lineHeight) >= drawHeight()) // text did not fit on screen
+    return firstLineChars;
+  return 0; // everything was drawn
+}
+
+uint16_t OLEDDisplay::getLineBreak(const char* text, uint16_t length, uint16_t maxLineWidth, uint16_t *lineLength, uint16_t *lineWidth) {
+  uint16_t strWidth = 0;
   uint16_t preferredBreakpoint = 0;
   uint16_t widthAtBreakpoint = 0;
-  uint16_t firstLineChars = 0;
-  uint16_t drawStringResult = 1; // later tested for 0 == error, so initialize to 1
 
-  for (uint16_t i = 0; i < length; i++) {
-    char c = (this->fontTableLookupFunction)(text[i]);
-    if (c == 0)
+  uint16_t kerningCount = 0;
+  const uint16_t *kerning = getKerningPairs(&kerningCount);
+  int32_t previousChar = -1;
+
+  for (uint16_t i = 0; i < length;) {
+    uint16_t start = i;
+    uint16_t startWidth = strWidth;
+    uint32_t code = (uint8_t) text[i];
+    if (code == 10) {
+      *lineLength = i;
+      *lineWidth = strWidth;
+      return i + 1;
+    }
+    if (code >= 0x80) {
+      code = getFontCode(Utf8Decode(text, length, &i));
+    } else {
+      i++;
+    }
+    if (code == 0)
       continue;
-    strWidth += pgm_read_word(fontData + JUMPTABLE_START + (c - firstChar) * JUMPTABLE_BYTES + JUMPTABLE_WIDTH);
+    strWidth += getCharWidth(code) * textScale;
+    if (kerning) {
+      int32_t charCode = getGlyphIndex(code);
+      strWidth += getKerning(kerning, kerningCount, previousChar, charCode) * textScale;
+      previousChar = charCode;
+    }
 
     // Always try to break on a space, dash or slash
-    if (text[i] == ' ' || text[i]== '-' || text[i] == '/') {
-      preferredBreakpoint = i + 1;
+    if (text[start] == ' ' || text[start]== '-' || text[start] == '/') {
+      preferredBreakpoint = i;
       widthAtBreakpoint = strWidth;
     }
 
     if (strWidth >= maxLineWidth) {
       if (preferredBreakpoint == 0) {
-        preferredBreakpoint = i;
-        widthAtBreakpoint = strWidth;
+        // No break in the line, wrap before this char unless it is the first one
+        preferredBreakpoint = start > 0 ? start : i;
+        widthAtBreakpoint = start > 0 ? startWidth : strWidth;
       }
-      drawStringResult = drawStringInternal(xMove, yMove + (lineNumber++) * lineHeight , &text[lastDrawnPos], preferredBreakpoint - lastDrawnPos, widthAtBreakpoint, true);
-      if (firstLineChars == 0)
-        firstLineChars = preferredBreakpoint;
-      lastDrawnPos = preferredBreakpoint;
-      // It is possible that we did not draw all letters to i so we need
-      // to account for the width of the chars from `i - preferredBreakpoint`
-      // by calculating the width we did not draw yet.
-      strWidth = strWidth - widthAtBreakpoint;
-      preferredBreakpoint = 0;
-      if (drawStringResult == 0) // we are past the display already?
-        break;
+      *lineLength = preferredBreakpoint;
+      *lineWidth = widthAtBreakpoint;
+      return preferredBreakpoint;
     }
   }
 
-  // Draw last part if needed
-  if (drawStringResult != 0 && lastDrawnPos < length) {
-    drawStringResult = drawStringInternal(xMove, yMove + (lineNumber++) * lineHeight , &text[lastDrawnPos], length - lastDrawnPos, getStringWidth(&text[lastDrawnPos], length - lastDrawnPos, true), true);
+  *lineLength = length;
+  *lineWidth = strWidth;
+  return length;
+}
+
+bool OLEDDisplay::layoutText(OLEDDisplayTextLayout *layout, const String &strUser, uint16_t maxLineWidth) {
+  layout->clear();
+
+  const char* text = strUser.c_str();
+  uint16_t length = strlen(text);
+  uint16_t lineLength, lineWidth;
+
+  // Count the lines first to allocate them at once
+  uint16_t lineCount = 0;
+  for (uint16_t start = 0; start < length; lineCount++) {
+    start += getLineBreak(&text[start], length - start, maxLineWidth, &lineLength, &lineWidth);
+  }
+
+  layout->text = (char*) malloc(length + 1);
+  layout->lines = (OLEDDisplayTextLine*) malloc(sizeof(OLEDDisplayTextLine) * (lineCount ? lineCount : 1));
+  if (!layout->text || !layout->lines) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][layoutText] Not enough memory to create the text layout\n");
+    layout->clear();
+    return false;
   }
+  memcpy(layout->text, text, length + 1);
 
-  if (drawStringResult == 0 || (yMove + lineNumber * lineHeight) >= this->height()) // text did not fit on screen
-    return firstLineChars;
-  return 0; // everything was drawn
+  uint16_t start = 0;
+  for (uint16_t line = 0; line < lineCount; line++) {
+    layout->lines[line].start = start;
+    start += getLineBreak(&text[start], length - start, maxLineWidth, &layout->lines[line].length, &layout->lines[line].width);
+  }
+  layout->lineCount  = lineCount;
+  layout->lineHeight = pgm_read_word(fontData + HEIGHT_POS) * textScale;
+  layout->font       = fontData;
+  layout->textScale  = textScale;
+  return true;
+}
+
+void OLEDDisplay::drawTextLayout(int16_t xMove, int16_t yMove, const OLEDDisplayTextLayout *layout, uint32_t scrollY, uint16_t height) {
+  if (!layout->lines || layout->lineHeight == 0) return;
+  if (fontData != layout->font) setFont(layout->font);
+  textScale = layout->textScale;
+
+  int32_t windowEnd = height ? yMove + height : drawHeight();
+
+  // Start at the first line in the window, no need to look at the ones above
+  uint32_t line = scrollY / layout->lineHeight;
+  int32_t  lineY = yMove - (int32_t) (scrollY % layout->lineHeight);
+  for (; line < layout->lineCount && lineY < windowEnd; line++, lineY += layout->lineHeight) {
+    const OLEDDisplayTextLine *textLine = &layout->lines[line];
+    drawStringInternal(xMove, lineY, &layout->text[textLine->start], textLine->length, textLine->width, true);
+  }
+}
+
+void OLEDDisplayTextLayout::clear() {
+  free(text);
+  free(lines);
+  text = NULL;
+  lines = NULL;
+  lineCount = 0;
+}
+
+// Writes value / 10^decimals with at least minDigits digits before the point to text, returns the length
+static uint8_t formatNumber(char *text, int32_t value, uint8_t minDigits, uint8_t decimals, char point) {
+  char     digits[10];
+  uint8_t  count     = 0;
+  uint32_t magnitude = value < 0 ? -(uint32_t) value : value;
+  do {
+    digits[count++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude);
+
+  uint8_t length = 0;
+  if (value < 0) text[length++] = '-';
+  for (uint8_t i = max(count, (uint8_t) (minDigits + decimals)); i > 0; i--) {
+    if (i == decimals) text[length++] = point;
+    text[length++] = i <= count ? digits[i - 1] : '0';
+  }
+  return length;
+}
+
+uint16_t OLEDDisplay::drawNumber(int16_t xMove, int16_t yMove, int32_t value, uint8_t minDigits, OLEDDisplayNumberCache *cache) {
+  char text[OLEDDISPLAY_NUMBER_LENGTH];
+  uint8_t length = formatNumber(text, value, minDigits < 1 ? 1 : minDigits > 10 ? 10 : minDigits, 0, 0);
+  return drawDigits(xMove, yMove, text, length, cache);
+}
+
+uint16_t OLEDDisplay::drawFixed(int16_t xMove, int16_t yMove, int32_t value, uint8_t decimals, char point, OLEDDisplayNumberCache *cache) {
+  char text[OLEDDISPLAY_NUMBER_LENGTH];
+  if (point != ',' && point != ':') point = '.';
+  uint8_t length = formatNumber(text, value, 1, decimals > 9 ? 9 : decimals, point);
+  return drawDigits(xMove, yMove, text, length, cache);
+}
+
+uint16_t OLEDDisplay::drawDigits(int16_t xMove, int16_t yMove, const char *text, uint8_t length, OLEDDisplayNumberCache *cache) {
+  uint16_t jumpTableStart   = getJumpTableStart();
+  const uint16_t *charData  = getCharData();
+  const uint16_t *metrics   = getFontMetrics();
+  bool     compressed       = pgm_read_word(fontData + WIDTH_POS) & FONT_RLE;
+  uint16_t fontHeight       = pgm_read_word(fontData + HEIGHT_POS);
+  uint8_t  scale            = textScale;
+  uint16_t textHeight       = fontHeight * scale;
+
+  uint16_t kerningCount    = 0;
+  const uint16_t *kerning  = getKerningPairs(&kerningCount);
+
+  if (!digitGlyphsValid) {
+    for (uint8_t i = 0; i < OLEDDISPLAY_DIGIT_COUNT; i++) {
+      OLEDDisplayDigitGlyph *glyph = &digitGlyphs[i];
+      int32_t charCode = getGlyphIndex((uint8_t) OLEDDISPLAY_DIGIT_CHARS[i]);
+      glyph->index    = charCode;
+      glyph->position = 0xFFFF;
+      glyph->size     = 0;
+      glyph->width    = 0;
+      glyph->advance  = 0;
+      glyph->bearing  = 0;
+      if (charCode < 0) continue;
+
+      const uint16_t *entry = fontData + jumpTableStart + charCode * JUMPTABLE_BYTES;
+      uint16_t msbJumpToChar = pgm_read_word(entry);
+      uint16_t lsbJumpToChar = pgm_read_word(entry + JUMPTABLE_LSB);
+      if (!(msbJumpToChar == 255 && lsbJumpToChar == 255)) glyph->position = (msbJumpToChar << 8) + lsbJumpToChar;
+      glyph->size    = pgm_read_word(entry + JUMPTABLE_SIZE);
+      glyph->width   = pgm_read_word(entry + JUMPTABLE_WIDTH);
+      glyph->advance = glyph->width;
+      if (metrics) {
+        uint16_t charMetrics = pgm_read_word(metrics + charCode);
+        glyph->advance = charMetrics & 0xFF;
+        glyph->bearing = (int8_t) (charMetrics >> 8);
+      }
+    }
+    digitGlyphsValid = true;
+  }
+
+  // Place the chars and find the columns they cover
+  uint8_t  glyphs[OLEDDISPLAY_NUMBER_LENGTH];
+  int16_t  cursorX[OLEDDISPLAY_NUMBER_LENGTH];
+  int16_t  cursor = 0;
+  int16_t  left   = 0;
+  int16_t  right  = 0;
+  int32_t  previousChar = -1;
+  for (uint8_t i = 0; i < length; i++) {
+    glyphs[i] = strchr(OLEDDISPLAY_DIGIT_CHARS, text[i]) - OLEDDISPLAY_DIGIT_CHARS;
+    const OLEDDisplayDigitGlyph *glyph = &digitGlyphs[glyphs[i]];
+    if (glyph->index >= 0) {
+      if (kerning) cursor += getKerning(kerning, kerningCount, previousChar, glyph->index) * scale;
+      previousChar = glyph->index;
+      left  = min(left, (int16_t) (cursor + glyph->bearing * scale));
+      right = max(right, (int16_t) (cursor + (glyph->bearing + glyph->width) * scale));
+    } else {
+      previousChar = -1;
+    }
+    cursorX[i] = cursor;
+    cursor += glyph->advance * scale;
+  }
+  uint16_t width = cursor;
+  right = max(right, cursor);
+
+  switch (textAlignment) {
+    case TEXT_ALIGN_CENTER_BOTH:
+      yMove -= textHeight >> 1;
+    // Fallthrough
+    case TEXT_ALIGN_CENTER:
+      xMove -= width >> 1; // divide by 2
+      break;
+    case TEXT_ALIGN_RIGHT:
+      xMove -= width;
+      break;
+    case TEXT_ALIGN_LEFT:
+      break;
+  }
+
+  // Only redraw the chars that changed if the others stay where they are
+  OLEDDISPLAY_COLOR foreground = color;
+  OLEDDISPLAY_COLOR background = color == WHITE ? BLACK : WHITE;
+  bool clear   = cache && color != INVERSE;
+  bool partial = clear && cache->length == length && cache->x == xMove && cache->y == yMove &&
+                 cache->font == fontData && cache->scale == scale && !metrics;
+  for (uint8_t i = 0; partial && i < length; i++) {
+    if (cache->text[i] == text[i]) continue;
+    const char *oldChar = strchr(OLEDDISPLAY_DIGIT_CHARS, cache->text[i]);
+    partial = oldChar && digitGlyphs[oldChar - OLEDDISPLAY_DIGIT_CHARS].advance == digitGlyphs[glyphs[i]].advance;
+  }
+
+  if (clear && !partial && cache->length) {
+    setColor(background);
+    fillRect(cache->x + cache->left, cache->y, cache->right - cache->left, cache->height);
+    setColor(foreground);
+  }
+
+  for (uint8_t i = 0; i < length; i++) {
+    const OLEDDisplayDigitGlyph *glyph = &digitGlyphs[glyphs[i]];
+    if (partial) {
+      if (cache->text[i] == text[i]) continue;
+      setColor(background);
+      fillRect(xMove + cursorX[i], yMove, glyph->advance * scale, textHeight);
+      setColor(foreground);
+    }
+    if (glyph->position == 0xFFFF) continue;
+    int16_t xPos = xMove + cursorX[i] + glyph->bearing * scale;
+    if (scale > 1) {
+      drawInternalScaled(xPos, yMove, glyph->width, fontHeight, charData, glyph->position, glyph->size, compressed, scale);
+    } else {
+      drawInternal(xPos, yMove, glyph->width, textHeight, charData, glyph->position, glyph->size, compressed);
+    }
+  }
+
+  if (cache) {
+    memcpy(cache->text, text, length);
+    cache->length = clear ? length : 0;
+    cache->x      = xMove;
+    cache->y      = yMove;
+    cache->left   = left;
+    cache->right  = right;
+    cache->height = textHeight;
+    cache->font   = fontData;
+    cache->scale  = scale;
+  }
+  return width;
 }
 
 uint16_t OLEDDisplay::getStringWidth(const char* text, uint16_t length, bool utf8) {
-  uint16_t firstChar        = pgm_read_word(fontData + FIRST_CHAR_POS);
+  // FNV-1a hash of the text to look it up in the cache, an sdbm hash to
+  // tell texts apart that land on the same FNV-1a hash
+  OLEDDisplayWidthCacheEntry *entry = NULL;
+  uint32_t hash = 2166136261UL ^ utf8;
+  uint32_t check = 0;
+  if (widthCache) {
+    for (uint16_t i = 0; i < length; i++) {
+      uint8_t c = text[i];
+      hash = (hash ^ c) * 16777619UL;
+      check = c + (check << 6) + (check << 16) - check;
+    }
+    entry = &widthCache[hash % widthCacheSize];
+    if (entry->hash == hash && entry->check == check && entry->length == length) return entry->width * textScale;
+  }
 
+  const uint8_t *widths = getFontWidths();
   uint16_t stringWidth = 0;
   uint16_t maxWidth = 0;
 
-  for (uint16_t i = 0; i < length; i++) {
-    char c = text[i];
-    if (utf8) {
-      c = (this->fontTableLookupFunction)(c);
-      if (c == 0)
-        continue;
+  uint16_t kerningCount = 0;
+  const uint16_t *kerning = getKerningPairs(&kerningCount);
+  int32_t previousChar = -1;
+
+  uint16_t i = 0;
+  while (i < length) {
+    // Runs of ASCII need no decoding
+    uint16_t end = utf8 ? i + Utf8AsciiLength(text + i, length - i) : length;
+    for (; i < end; i++) {
+      uint8_t c = text[i];
+      if (c == 10) {
+        maxWidth = max(maxWidth, stringWidth);
+        stringWidth = 0;
+        previousChar = -1;
+      } else {
+        stringWidth += widths ? widths[c] : readCharWidth(c);
+        if (kerning) {
+          int32_t charCode = getGlyphIndex(c);
+          stringWidth += getKerning(kerning, kerningCount, previousChar, charCode);
+          previousChar = charCode;
+        }
+      }
+    }
+    if (i < length) {
+      uint32_t code = getFontCode(Utf8Decode(text, length, &i));
+      if (code) {
+        stringWidth += getCharWidth(code);
+        if (kerning) {
+          int32_t charCode = getGlyphIndex(code);
+          stringWidth += getKerning(kerning, kerningCount, previousChar, charCode);
+          previousChar = charCode;
+        }
+      }
     }
-    stringWidth += pgm_read_word(fontData + JUMPTABLE_START + (c - firstChar) * JUMPTABLE_BYTES + JUMPTABLE_WIDTH);
-    if (c == 10) {
-      maxWidth = max(maxWidth, stringWidth);
-      stringWidth = 0;
+  }
+
+  stringWidth = max(maxWidth, stringWidth);
+  if (entry) {
+    entry->hash = hash;
+    entry->check = check;
+    entry->length = length;
+    entry->width = stringWidth;
+  }
+  return stringWidth * textScale;
+}
+
+uint16_t OLEDDisplay::getCharWidth(uint32_t code) {
+  if (code <= 0xFF) {
+    const uint8_t *widths = getFontWidths();
+    if (widths) return widths[code];
+  }
+  return readCharWidth(code);
+}
+
+uint16_t OLEDDisplay::readCharWidth(uint32_t code) {
+  int32_t glyph = getGlyphIndex(code);
+  if (glyph < 0) return 0;
+  const uint16_t *metrics = getFontMetrics();
+  if (metrics) return pgm_read_word(metrics + glyph) & 0xFF;
+  return pgm_read_word(fontData + getJumpTableStart() + (uint32_t) glyph * JUMPTABLE_BYTES + JUMPTABLE_WIDTH);
+}
+
+const uint8_t *OLEDDisplay::getFontWidths() {
+#ifdef OLEDDISPLAY_REDUCE_MEMORY
+  return NULL;
+#else
+  if (fontWidthsValid) return fontWidths;
+  if (!fontWidths) {
+    fontWidths = (uint8_t *) malloc(256);
+    if (!fontWidths) {
+      DEBUG_OLEDDISPLAY("[OLEDDISPLAY][getFontWidths] Not enough memory for the width table\n");
+      return NULL;
     }
   }
+  for (uint16_t code = 0; code <= 0xFF; code++) {
+    fontWidths[code] = readCharWidth(code);
+  }
+  fontWidthsValid = true;
+  return fontWidths;
+#endif
+}
 
-  return max(maxWidth, stringWidth);
+bool OLEDDisplay::setStringWidthCache(uint8_t entries) {
+  if (widthCache) {
+    free(widthCache);
+    widthCache = NULL;
+    widthCacheSize = 0;
+  }
+  if (!entries) return true;
+
+  widthCache = (OLEDDisplayWidthCacheEntry *) calloc(entries, sizeof(OLEDDisplayWidthCacheEntry));
+  if (!widthCache) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][setStringWidthCache] Not enough memory for the cache\n");
+    return false;
+  }
+  widthCacheSize = entries;
+  return true;
+}
+
+int32_t OLEDDisplay::getGlyphIndex(uint32_t code) {
+  uint16_t firstChar = pgm_read_word(fontData + FIRST_CHAR_POS);
+  if (firstChar != FONT_SPARSE) {
+    uint16_t numChars = pgm_read_word(fontData + CHAR_NUM_POS);
+    if (code < firstChar || code - firstChar >= numChars) return -1;
+    return code - firstChar;
+  }
+
+  // Binary search for the last range starting at or below code
+  const uint16_t *ranges = fontData + RANGETABLE_START;
+  uint16_t low = 0;
+  uint16_t high = pgm_read_word(fontData + RANGE_NUM_POS);
+  uint32_t first = 0;
+  while (low < high) {
+    uint16_t middle = (low + high) >> 1;
+    const uint16_t *range = ranges + middle * RANGETABLE_BYTES;
+    uint32_t rangeFirst = ((uint32_t) pgm_read_word(range + RANGETABLE_FIRST_HIGH) << 16) | pgm_read_word(range + RANGETABLE_FIRST_LOW);
+    if (rangeFirst <= code) {
+      low = middle + 1;
+      first = rangeFirst;
+    } else {
+      high = middle;
+    }
+  }
+  if (low == 0) return -1;
+
+  const uint16_t *range = ranges + (low - 1) * RANGETABLE_BYTES;
+  if (code - first >= pgm_read_word(range + RANGETABLE_COUNT)) return -1;
+  return pgm_read_word(range + RANGETABLE_GLYPH) + (code - first);
+}
+
+uint16_t OLEDDisplay::getJumpTableStart() {
+  if (pgm_read_word(fontData + FIRST_CHAR_POS) != FONT_SPARSE) return JUMPTABLE_START;
+  return RANGETABLE_START + pgm_read_word(fontData + RANGE_NUM_POS) * RANGETABLE_BYTES;
+}
+
+const uint16_t *OLEDDisplay::getFontMetrics() {
+  if (!(pgm_read_word(fontData + WIDTH_POS) & FONT_METRICS)) return NULL;
+  return fontData + getJumpTableStart() + (uint32_t) pgm_read_word(fontData + CHAR_NUM_POS) * JUMPTABLE_BYTES;
+}
+
+const uint16_t *OLEDDisplay::getKerningPairs(uint16_t *count) {
+  const uint16_t *metrics = getFontMetrics();
+  *count = 0;
+  if (!metrics) return NULL;
+  const uint16_t *kerning = metrics + pgm_read_word(fontData + CHAR_NUM_POS);
+  *count = pgm_read_word(kerning);
+  return *count ? kerning + 1 : NULL;
+}
+
+const uint16_t *OLEDDisplay::getCharData() {
+  const uint16_t *metrics = getFontMetrics();
+  if (!metrics) {
+    return fontData + getJumpTableStart() + (uint32_t) pgm_read_word(fontData + CHAR_NUM_POS) * JUMPTABLE_BYTES;
+  }
+  const uint16_t *kerning = metrics + pgm_read_word(fontData + CHAR_NUM_POS);
+  return kerning + 1 + (uint32_t) pgm_read_word(kerning) * KERNING_BYTES;
+}
+
+int16_t OLEDDisplay::getKerning(const uint16_t *pairs, uint16_t count, int32_t left, int32_t right) {
+  if (left < 0 || right < 0) return 0;
+
+  // Binary search for the pair
+  uint32_t key = ((uint32_t) left << 16) | right;
+  uint16_t low = 0;
+  uint16_t high = count;
+  while (low < high) {
+    uint16_t middle = (low + high) >> 1;
+    const uint16_t *pair = pairs + middle * KERNING_BYTES;
+    uint32_t pairKey = ((uint32_t) pgm_read_word(pair) << 16) | pgm_read_word(pair + 1);
+    if (pairKey == key) return (int16_t) pgm_read_word(pair + 2);
+    if (pairKey < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return 0;
+}
+
+uint32_t OLEDDisplay::getFontCode(uint32_t codePoint) {
+  if (pgm_read_word(fontData + FIRST_CHAR_POS) == FONT_SPARSE) return codePoint;
+  return (this->fontTableLookupFunction)(codePoint);
 }
 
 uint16_t OLEDDisplay::getStringWidth(const String &strUser) {
@@ -750,10 +1298,24 @@ void OLEDDisplay::setTextAlignment(OLEDDISPLAY_TEXT_ALIGNMENT textAlignment) {
   this->textAlignment = textAlignment;
 }
 
+void OLEDDisplay::setTextScale(uint8_t scale) {
+  this->textScale = scale < 1 ? 1 : scale > 4 ? 4 : scale;
+}
+
 void OLEDDisplay::setFont(const uint16_t *fontData) {
+  if (this->fontData == fontData) return;
   this->fontData = fontData;
+  // Widths of the old font are of no use anymore
+  this->fontWidthsValid = false;
+  this->digitGlyphsValid = false;
+  if (this->widthCache) {
+    memset(this->widthCache, 0, this->widthCacheSize * sizeof(OLEDDisplayWidthCacheEntry));
+  }
   // New font, so must recalculate. Whatever was there is gone at next print.
-  setLogBuffer();
+  // Without a logBuffer there is nothing to do, printing creates one when needed.
+  if (this->logBufferSize) {
+    setLogBuffer();
+  }
 }
 
 void OLEDDisplay::setFont(const char *fontData) {
@@ -821,8 +1383,210 @@ void OLEDDisplay::mirrorScreen() {
   sendCommand(COMSCANDEC);           //Mirror screen
 }
 
+void OLEDDisplay::startScrollHorizontal(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                                        OLEDDISPLAY_SCROLL_SPEED speed) {
+  if (!supportsHardwareScroll()) return;
+  // Push what has been drawn so far, the RAM can't be written once scrolling
+  if (!scrolling) display();
+  sendCommand(DEACTIVATESCROLL);
+  sendCommand(direction == SCROLL_LEFT ? LEFTHORIZONTALSCROLL : RIGHTHORIZONTALSCROLL);
+  sendCommand(0x00);
+  sendCommand(startPage & 0x07);
+  sendCommand(speed);
+  sendCommand(endPage & 0x07);
+  sendCommand(0x00);
+  sendCommand(0xFF);
+  sendCommand(ACTIVATESCROLL);
+  scrolling = true;
+}
+
+void OLEDDisplay::startScrollDiagonal(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                                      uint8_t verticalOffset, OLEDDISPLAY_SCROLL_SPEED speed,
+                                      uint8_t fixedRows, uint8_t scrollRows) {
+  if (!supportsHardwareScroll()) return;
+  if (fixedRows >= this->height()) return;
+  if (scrollRows == 0 || fixedRows + scrollRows > this->height()) {
+    scrollRows = this->height() - fixedRows;
+  }
+  if (!scrolling) display();
+  sendCommand(DEACTIVATESCROLL);
+  sendCommand(SETVERTICALSCROLLAREA);
+  sendCommand(fixedRows);
+  sendCommand(scrollRows);
+  sendCommand(direction == SCROLL_LEFT ? VERTICALLEFTHORIZONTALSCROLL : VERTICALRIGHTHORIZONTALSCROLL);
+  sendCommand(0x00);
+  sendCommand(startPage & 0x07);
+  sendCommand(speed);
+  sendCommand(endPage & 0x07);
+  sendCommand(verticalOffset & 0x3F);
+  sendCommand(ACTIVATESCROLL);
+  scrolling = true;
+}
+
+void OLEDDisplay::stopScroll() {
+  if (!scrolling) return;
+  sendCommand(DEACTIVATESCROLL);
+  scrolling = false;
+
+  // The panel RAM no longer matches what was sent last, force
+  // the next display() to rewrite the whole screen.
+  if (buffer_back) {
+    for (uint16_t i = 0; i < displayBufferSize; i++) {
+      buffer_back[i] = ~buffer[i];
+    }
+  }
+  display();
+}
+
+void OLEDDisplay::display(void) {
+  if (!beginTransfer()) return;
+  while (transferNext());
+}
+
+bool OLEDDisplay::beginTransfer(uint8_t *frame) {
+  // The panel RAM must not be written while the controller is scrolling
+  if (scrolling) return false;
+  transferFrame = frame ? frame : buffer;
+
+  uint32_t start = 0;
+  if (frameStats) {
+    start = micros();
+    frameDrawTime = frameStats->frames ? start - frameEnd : 0;
+    frameDiffTime = 0;
+    frameTransferTime = 0;
+    frameTransactions = 0;
+    frameBusBytes = 0;
+  }
+
+  uint8_t pages = this->height() / 8;
+  if (!buffer_back) {
+    // Single buffering, send everything
+    transferMinX = 0;
+    transferMaxX = this->width() - 1;
+    transferMinPage = 0;
+    transferMaxPage = pages - 1;
+    transferPage = transferMinPage;
+    return true;
+  }
+
+  uint8_t  minBoundY = UINT8_MAX;
+  uint8_t  maxBoundY = 0;
+
+  uint16_t minBoundX = UINT16_MAX;
+  uint16_t maxBoundX = 0;
+
+  // Calculate the bounding box of changes
+  // and copy buffer[pos] to buffer_back[pos] unless the buffers are swapped;
+  for (uint8_t y = 0; y < pages; y++) {
+    uint16_t row = y * this->width();
+    for (uint16_t x = 0; x < this->width(); x++) {
+      if (transferFrame[x + row] != buffer_back[x + row]) {
+        if (y < minBoundY) minBoundY = y;
+        if (y > maxBoundY) maxBoundY = y;
+        if (x < minBoundX) minBoundX = x;
+        if (x > maxBoundX) maxBoundX = x;
+      }
+    }
+    if (!bufferSwap) {
+      memcpy(buffer_back + row, transferFrame + row, this->width());
+    }
+    yield();
+  }
+
+  // If the minBoundY wasn't updated
+  // we can savely assume that buffer_back[pos] == buffer[pos]
+  // holdes true for all values of pos
+  if (frameStats) {
+    frameDiffTime = micros() - start;
+  }
+  if (minBoundY == UINT8_MAX) {
+    finishTransfer(0, 0);
+    return false;
+  }
+
+  transferMinX = minBoundX;
+  transferMaxX = maxBoundX;
+  transferMinPage = minBoundY;
+  transferMaxPage = maxBoundY;
+  transferPage = transferMinPage;
+  return true;
+}
+
+bool OLEDDisplay::transferNext() {
+  if (transferPage > transferMaxPage) return false;
+  uint32_t start = frameStats ? micros() : 0;
+  sendPageSpan(transferPage, transferMinX, transferMaxX);
+  if (frameStats) {
+    frameTransferTime += micros() - start;
+  }
+  if (traceSink) {
+    traceSink->trace(TRACE_DATA, transferFrame + transferMinX + transferPage * this->width(), transferMaxX - transferMinX + 1);
+  }
+  transferPage++;
+  yield();
+  if (transferPage <= transferMaxPage) return true;
+  uint8_t pages = transferMaxPage - transferMinPage + 1;
+  finishTransfer((transferMaxX - transferMinX + 1) * pages, pages);
+  return false;
+}
+
+static void updateStatValue(OLEDDisplayStatValue &value, uint32_t last, uint32_t frames) {
+  value.last = last;
+  if (frames == 1 || last < value.min) value.min = last;
+  if (frames == 1 || last > value.max) value.max = last;
+  value.total += last;
+  value.avg = value.total / frames;
+}
+
+void OLEDDisplay::finishTransfer(uint16_t dirtyBytes, uint8_t pages) {
+  if (frameStats) {
+    uint32_t frames = ++frameStats->frames;
+    updateStatValue(frameStats->dirtyBytes, dirtyBytes, frames);
+    updateStatValue(frameStats->pages, pages, frames);
+    updateStatValue(frameStats->transactions, frameTransactions, frames);
+    updateStatValue(frameStats->busBytes, frameBusBytes, frames);
+    updateStatValue(frameStats->diffTime, frameDiffTime, frames);
+    updateStatValue(frameStats->transferTime, frameTransferTime, frames);
+    updateStatValue(frameStats->drawTime, frameDrawTime, frames);
+    frameEnd = micros();
+  }
+  if (traceSink) {
+    traceSink->trace(TRACE_FRAME, NULL, 0);
+  }
+
+  if (!bufferSwap || !buffer_back) return;
+  // The frame on the display becomes the back buffer, the previous back
+  // buffer is free to draw the next frame into
+  uint8_t *sent = transferFrame;
+  transferFrame = buffer_back;
+  buffer_back = sent;
+  if (buffer == sent) buffer = transferFrame;
+}
+
+void OLEDDisplay::setBufferSwap(bool swap) {
+  bufferSwap = swap;
+}
+
+void OLEDDisplay::setTraceSink(OLEDDisplayTraceSink *sink) {
+  traceSink = sink;
+  if (sink) {
+    sink->begin(this->width(), this->height());
+    // A sink attached after init() missed the addressing mode, every transfer
+    // sets the column and page window itself
+    traceCommand(MEMORYMODE);
+    traceCommand(0x00);
+  }
+}
+
+void OLEDDisplay::setFrameStats(OLEDDisplayFrameStats *stats) {
+  frameStats = stats;
+  if (stats) {
+    memset(stats, 0, sizeof(OLEDDisplayFrameStats));
+  }
+}
+
 void OLEDDisplay::clear(void) {
-  memset(buffer, 0, displayBufferSize);
+  memset(drawBuffer(), 0, drawBufferSize());
 }
 
 void OLEDDisplay::drawLogBuffer(uint16_t xMove, uint16_t yMove) {
@@ -835,6 +1599,9 @@ void OLEDDisplay::drawLogBuffer() {
   uint16_t lineHeight = pgm_read_word(fontData + HEIGHT_POS);
   // Always align left
   setTextAlignment(TEXT_ALIGN_LEFT);
+  // and print at the size of the font
+  uint8_t scale = textScale;
+  textScale = 1;
 
   // State values
   uint16_t length   = 0;
@@ -852,7 +1619,7 @@ void OLEDDisplay::drawLogBuffer() {
     if (this->logBuffer[i] == 10) {
       // Draw string on line `line` from lastPos to length
       // Passing 0 as the lenght because we are in TEXT_ALIGN_LEFT
-      drawStringInternal(0, 0 - shiftUp + (line++) * lineHeight, &this->logBuffer[lastPos], length, 0, false);
+      drawStringInternal(0, 0 - shiftUp + (line++) * lineHeight, &this->logBuffer[lastPos], length, 0, true);
       // Remember last pos
       lastPos = i;
       // Reset length
@@ -861,8 +1628,9 @@ void OLEDDisplay::drawLogBuffer() {
   }
   // Draw the remaining string
   if (length > 0) {
-    drawStringInternal(0, 0 - shiftUp + line * lineHeight, &this->logBuffer[lastPos], length, 0, false);
+    drawStringInternal(0, 0 - shiftUp + line * lineHeight, &this->logBuffer[lastPos], length, 0, true);
   }
+  textScale = scale;
 }
 
 uint16_t OLEDDisplay::getWidth(void) {
@@ -877,7 +1645,32 @@ void OLEDDisplay::cls() {
   clear();
   this->logBufferFilled = 0;
   this->logBufferLine = 0;
+  this->logBufferDirty = false;
+  display();
+}
+
+void OLEDDisplay::setLogBufferRedrawInterval(uint16_t interval) {
+  this->logBufferRedrawInterval = interval;
+}
+
+void OLEDDisplay::flush() {
+  if (this->logBufferDirty) {
+    redrawLogBuffer(true);
+  }
+}
+
+void OLEDDisplay::redrawLogBuffer(bool force) {
+  this->logBufferDirty = true;
+  uint32_t now = millis();
+  if (!force && this->logBufferRedrawInterval &&
+      (now - this->logBufferLastRedraw) < this->logBufferRedrawInterval) {
+    return;
+  }
+  clear();
+  drawLogBuffer();
   display();
+  this->logBufferDirty = false;
+  this->logBufferLastRedraw = now;
 }
 
 bool OLEDDisplay::setLogBuffer(uint16_t lines, uint16_t chars) {
@@ -893,8 +1686,11 @@ bool OLEDDisplay::setLogBuffer(){
 		return false;
   
   // we're always starting over
-  if (logBuffer != NULL)
+  if (logBuffer != NULL) {
     free(logBuffer);
+    logBuffer = NULL;
+  }
+  logBufferSize = 0;
 
   // figure out how big it needs to be
   uint16_t textHeight = pgm_read_word(fontData + HEIGHT_POS);
@@ -917,6 +1713,7 @@ bool OLEDDisplay::setLogBuffer(){
   this->logBuffer         = (char *) malloc(size * sizeof(uint8_t));
   if(!this->logBuffer) {
     DEBUG_OLEDDISPLAY("[OLEDDISPLAY][setLogBuffer] Not enough memory to create log buffer\n");
+    this->logBufferSize = 0;
     return false;
   }
 
@@ -937,10 +1734,7 @@ size_t OLEDDisplay::write(uint8_t c) {
   // Don't waste space on \r\n line endings, dropping \r
   if (c == 13) return 1;
 
-  // convert UTF-8 character to font table index
-  c = (this->fontTableLookupFunction)(c);
-  // drop unknown character
-  if (c == 0) return 1;
+  // The logBuffer keeps the UTF-8 bytes, they are decoded when it is drawn
 
   bool maxLineReached = this->logBufferLine >= this->logBufferMaxLines;
   bool bufferFull = this->logBufferFilled >= this->logBufferSize;
@@ -989,9 +1783,7 @@ size_t OLEDDisplay::write(uint8_t c) {
 
   // Draw to screen unless we're writing a whole string at a time
   if (!this->inhibitDrawLogBuffer) {
-    clear();
-    drawLogBuffer();
-    display();
+    redrawLogBuffer(false);
   }
 
   // We always claim we printed it all
@@ -1000,17 +1792,19 @@ size_t OLEDDisplay::write(uint8_t c) {
 
 size_t OLEDDisplay::write(const char* str) {
   if (str == NULL) return 0;
-  size_t length = strlen(str);
+  return write((const uint8_t*) str, strlen(str));
+}
+
+size_t OLEDDisplay::write(const uint8_t* buffer, size_t size) {
+  if (buffer == NULL) return 0;
   // If we write a string, only do the drawLogBuffer at the end, not every time we write a char
   this->inhibitDrawLogBuffer = true;
-  for (size_t i = 0; i < length; i++) {
-    write(str[i]);
+  for (size_t i = 0; i < size; i++) {
+    write(buffer[i]);
   }
   this->inhibitDrawLogBuffer = false;
-  clear();
-  drawLogBuffer();
-  display();
-  return length;
+  redrawLogBuffer(false);
+  return size;
 }
 
 #ifdef __MBED__
@@ -1090,14 +1884,49 @@ void OLEDDisplay::sendInitCommands(void) {
   sendCommand(0x40);	        //0x40 default, to lower the contrast, put 0
   sendCommand(DISPLAYALLON_RESUME);
   sendCommand(NORMALDISPLAY);
-  sendCommand(0x2e);            // stop scroll
+  sendCommand(DEACTIVATESCROLL);
   sendCommand(DISPLAYON);
+  scrolling = false;
 }
 
-void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint16_t *data, uint16_t offset, uint16_t bytesInData) {
+// Unpacks RLE compressed glyph data byte by byte, see FONT_RLE
+class OLEDGlyphDecoder {
+  public:
+    OLEDGlyphDecoder(const uint16_t *data, uint16_t offset) : data(data), position(offset), count(0), repeat(false), value(0) {};
+
+    uint8_t next() {
+      if (count == 0) {
+        uint8_t control = readByte();
+        repeat = control & 0x80;
+        count = (control & 0x7F) + 1;
+        if (repeat) value = readByte();
+      }
+      count--;
+      return repeat ? value : readByte();
+    };
+
+  private:
+    uint8_t readByte() {
+      uint16_t word = pgm_read_word(data + (position >> 1));
+      return (position++ & 1) ? word >> 8 : word & 0xFF;
+    };
+
+    const uint16_t *data;
+    uint32_t position;
+    uint8_t  count;
+    bool     repeat;
+    uint8_t  value;
+};
+
+void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint16_t *data, uint16_t offset, uint16_t bytesInData, bool compressed) {
   if (width < 0 || height < 0) return;
-  if (yMove + height < 0 || yMove > this->height())  return;
-  if (xMove + width  < 0 || xMove > this->width())   return;
+  if (yMove + height < 0 || yMove > drawHeight())  return;
+  if (xMove + width  < 0 || xMove > drawWidth())   return;
+
+  // The page buffer drawn into, see setDrawTarget()
+  uint8_t  *target      = drawBuffer();
+  uint16_t  targetWidth = drawWidth();
+  uint16_t  targetSize  = drawBufferSize();
 
   uint8_t  rasterHeight = 1 + ((height - 1) >> 3); // fast ceil(height / 8.0)
   int8_t   yOffset      = yMove & 7;
@@ -1107,8 +1936,22 @@ void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t widt
   int16_t initYMove   = yMove;
   int8_t  initYOffset = yOffset;
 
+  // Compressed glyphs are unpacked while drawing, no glyph buffer needed
+  OLEDGlyphDecoder decoder(data, offset);
 
-  for (uint16_t i = 0; i < bytesInData; i++) {
+  // Only visit the columns on the display
+  uint16_t firstByte = 0;
+  if (xMove < 0) {
+    firstByte = min((uint16_t) (-xMove * rasterHeight), bytesInData);
+    if (compressed) {
+      for (uint16_t i = 0; i < firstByte; i++) decoder.next();
+    }
+  }
+  if (xMove + width > targetWidth) {
+    bytesInData = min((uint16_t) ((targetWidth - xMove) * rasterHeight), bytesInData);
+  }
+
+  for (uint16_t i = firstByte; i < bytesInData; i++) {
 
     // Reset if next horizontal drawing phase is started.
     if ( i % rasterHeight == 0) {
@@ -1116,29 +1959,29 @@ void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t widt
       yOffset = initYOffset;
     }
 
-    uint16_t currentByte =  pgm_read_word(data + offset + i);
+    uint16_t currentByte = compressed ? decoder.next() : pgm_read_word(data + offset + i);
 
     int16_t xPos = xMove + (i / rasterHeight);
-    int16_t yPos = ((yMove >> 3) + (i % rasterHeight)) * this->width();
+    int16_t yPos = ((yMove >> 3) + (i % rasterHeight)) * targetWidth;
 
 //    int16_t yScreenPos = yMove + yOffset;
     int16_t dataPos    = xPos  + yPos;
 
-    if (dataPos >=  0  && dataPos < displayBufferSize &&
-        xPos    >=  0  && xPos    < this->width() ) {
+    if (dataPos >=  0  && dataPos < targetSize &&
+        xPos    >=  0  && xPos    < targetWidth ) {
 
       if (yOffset >= 0) {
         switch (this->color) {
-          case WHITE:   buffer[dataPos] |= currentByte << yOffset; break;
-          case BLACK:   buffer[dataPos] &= ~(currentByte << yOffset); break;
-          case INVERSE: buffer[dataPos] ^= currentByte << yOffset; break;
+          case WHITE:   target[dataPos] |= currentByte << yOffset; break;
+          case BLACK:   target[dataPos] &= ~(currentByte << yOffset); break;
+          case INVERSE: target[dataPos] ^= currentByte << yOffset; break;
         }
 
-        if (dataPos < (displayBufferSize - this->width())) {
+        if (dataPos < (targetSize - targetWidth)) {
           switch (this->color) {
-            case WHITE:   buffer[dataPos + this->width()] |= currentByte >> (8 - yOffset); break;
-            case BLACK:   buffer[dataPos + this->width()] &= ~(currentByte >> (8 - yOffset)); break;
-            case INVERSE: buffer[dataPos + this->width()] ^= currentByte >> (8 - yOffset); break;
+            case WHITE:   target[dataPos + targetWidth] |= currentByte >> (8 - yOffset); break;
+            case BLACK:   target[dataPos + targetWidth] &= ~(currentByte >> (8 - yOffset)); break;
+            case INVERSE: target[dataPos + targetWidth] ^= currentByte >> (8 - yOffset); break;
           }
         }
       } else {
@@ -1146,9 +1989,9 @@ void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t widt
         yOffset = -yOffset;
 
         switch (this->color) {
-          case WHITE:   buffer[dataPos] |= currentByte >> yOffset; break;
-          case BLACK:   buffer[dataPos] &= ~(currentByte >> yOffset); break;
-          case INVERSE: buffer[dataPos] ^= currentByte >> yOffset; break;
+          case WHITE:   target[dataPos] |= currentByte >> yOffset; break;
+          case BLACK:   target[dataPos] &= ~(currentByte >> yOffset); break;
+          case INVERSE: target[dataPos] ^= currentByte >> yOffset; break;
         }
 
         // Prepare for next iteration by moving one block up
@@ -1164,6 +2007,69 @@ void inline OLEDDisplay::drawInternal(int16_t xMove, int16_t yMove, int16_t widt
   }
 }
 
+// Four pixels of a glyph column stretched to 2, 3 or 4 times the height
+const uint16_t OLEDDISPLAY_scaledNibble[3][16] PROGMEM = {
+  { 0x0000, 0x0003, 0x000C, 0x000F, 0x0030, 0x0033, 0x003C, 0x003F, 0x00C0, 0x00C3, 0x00CC, 0x00CF, 0x00F0, 0x00F3, 0x00FC, 0x00FF },
+  { 0x0000, 0x0007, 0x0038, 0x003F, 0x01C0, 0x01C7, 0x01F8, 0x01FF, 0x0E00, 0x0E07, 0x0E38, 0x0E3F, 0x0FC0, 0x0FC7, 0x0FF8, 0x0FFF },
+  { 0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF, 0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF }
+};
+
+void OLEDDisplay::drawInternalScaled(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint16_t *data, uint16_t offset, uint16_t bytesInData, bool compressed, uint8_t scale) {
+  if (width < 0 || height < 0) return;
+  if (yMove + height * scale < 0 || yMove > drawHeight())  return;
+  if (xMove + width * scale < 0 || xMove > drawWidth())   return;
+
+  // The page buffer drawn into, see setDrawTarget()
+  uint8_t  *target      = drawBuffer();
+  uint16_t  targetWidth = drawWidth();
+  uint16_t  targetSize  = drawBufferSize();
+
+  uint8_t  rasterHeight = 1 + ((height - 1) >> 3); // fast ceil(height / 8.0)
+  uint8_t  yOffset      = yMove & 7;
+  // Pages of the draw target, a strip may end with a partial page
+  int16_t  displayPages = targetSize / targetWidth;
+  const uint16_t *nibbles = OLEDDISPLAY_scaledNibble[scale - 2];
+
+  bytesInData = bytesInData == 0 ? width * rasterHeight : bytesInData;
+
+  OLEDGlyphDecoder decoder(data, offset);
+
+  for (uint16_t i = 0; i < bytesInData; i++) {
+    uint8_t currentByte = compressed ? decoder.next() : pgm_read_word(data + offset + i);
+    if (currentByte == 0) continue;
+
+    // The 8 pixels of the byte become 8 * scale pixels, starting at any row
+    uint32_t column = pgm_read_word(nibbles + (currentByte & 0x0F)) |
+                      ((uint32_t) pgm_read_word(nibbles + (currentByte >> 4)) << (scale * 4));
+    uint8_t  first  = column << yOffset;
+    uint32_t rest   = column >> (8 - yOffset);
+    int16_t  page   = (yMove + (i % rasterHeight) * 8 * scale) >> 3;
+    int16_t  xPos   = xMove + (i / rasterHeight) * scale;
+
+    for (uint8_t repeat = 0; repeat < scale; repeat++, xPos++) {
+      if (xPos < 0 || xPos >= targetWidth) continue;
+      uint8_t  data    = first;
+      uint32_t pending = rest;
+      for (int16_t destPage = page; destPage < displayPages; destPage++) {
+        if (destPage >= 0) {
+          uint8_t *dest = target + destPage * targetWidth + xPos;
+          switch (this->color) {
+            case WHITE:   *dest |= data; break;
+            case BLACK:   *dest &= ~data; break;
+            case INVERSE: *dest ^= data; break;
+          }
+        }
+        if (pending == 0) break;
+        data = pending;
+        pending >>= 8;
+      }
+    }
+#ifndef __MBED__
+    yield();
+#endif
+  }
+}
+
 // You need to free the char!
 char* OLEDDisplay::utf8ascii(const String &str) {
   uint16_t k = 0;
@@ -1179,9 +2085,15 @@ char* OLEDDisplay::utf8ascii(const String &str) {
 
   length--;
 
-  for (uint16_t i=0; i < length; i++) {
-    char c = (this->fontTableLookupFunction)(s[i]);
-    if (c!=0) {
+  for (uint16_t i=0; i < length;) {
+    uint32_t c = (uint8_t) s[i];
+    if (c >= 0x80) {
+      c = (this->fontTableLookupFunction)(Utf8Decode(s, length, &i));
+    } else {
+      i++;
+    }
+    // Only single byte font table indices fit
+    if (c != 0 && c <= 0xFF) {
       s[k++]=c;
     }
   }
@@ -1194,27 +2106,60 @@ char* OLEDDisplay::utf8ascii(const String &str) {
 
 void OLEDDisplay::setFontTableLookupFunction(FontTableLookupFunction function) {
   this->fontTableLookupFunction = function;
+  // Cached widths of UTF-8 text depend on the lookup
+  if (this->widthCache) {
+    memset(this->widthCache, 0, this->widthCacheSize * sizeof(OLEDDisplayWidthCacheEntry));
+  }
 }
 
 
-char DefaultFontTableLookup(const uint8_t ch) {
-    // UTF-8 to font table index converter
-    // Code form http://playground.arduino.cc/Main/Utf8ascii
-	static uint8_t LASTCHAR;
-
-	if (ch < 128) { // Standard ASCII-set 0..0x7F handling
-		LASTCHAR = 0;
-		return ch;
-	}
+uint32_t DefaultFontTableLookup(const uint32_t codePoint) {
+  // Latin-1 fonts: code points up to 0xFF are the font table index
+  if (codePoint <= 0xFF) return codePoint;
+  if (codePoint == 0x20AC) return 0x80;   // special case Euro-symbol
+  return 0;   // otherwise: return zero, if character has to be ignored
+}
 
-	uint8_t last = LASTCHAR;   // get last char
-	LASTCHAR = ch;
+uint32_t Utf8Decode(const char *text, uint16_t length, uint16_t *index) {
+  const uint8_t *s = (const uint8_t *) text + *index;
+  uint16_t left = length - *index;
+  uint8_t  c = s[0];
+  (*index)++;
+  if (c < 0x80) return c;
+
+  uint8_t  extra;
+  uint32_t codePoint;
+  uint32_t minimum;
+  if ((c & 0xE0) == 0xC0) {
+    extra = 1; codePoint = c & 0x1F; minimum = 0x80;
+  } else if ((c & 0xF0) == 0xE0) {
+    extra = 2; codePoint = c & 0x0F; minimum = 0x800;
+  } else if ((c & 0xF8) == 0xF0) {
+    extra = 3; codePoint = c & 0x07; minimum = 0x10000;
+  } else {
+    return 0xFFFD;   // continuation byte without a start, or invalid byte
+  }
+  if (extra >= left) return 0xFFFD;
 
-	switch (last) {    // conversion depnding on first UTF8-character
-		case 0xC2: return (uint8_t) ch;
-		case 0xC3: return (uint8_t) (ch | 0xC0);
-		case 0x82: if (ch == 0xAC) return (uint8_t) 0x80;    // special case Euro-symbol
-	}
+  for (uint8_t i = 1; i <= extra; i++) {
+    if ((s[i] & 0xC0) != 0x80) return 0xFFFD;
+    codePoint = (codePoint << 6) | (s[i] & 0x3F);
+  }
+  // Overlong encodings, surrogates and values beyond Unicode are not characters
+  if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+    return 0xFFFD;
+  }
+  *index += extra;
+  return codePoint;
+}
 
-	return (uint8_t) 0; // otherwise: return zero, if character has to be ignored
+uint16_t Utf8AsciiLength(const char *text, uint16_t length) {
+  uint16_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    uint32_t word;
+    memcpy(&word, text + i, 4);
+    if (word & 0x80808080) break;
+  }
+  while (i < length && !(text[i] & 0x80)) i++;
+  return i;
 }
@@ -40,6 +40,9 @@
 #include <mbed.h>
 #define delay(x)	wait_ms(x)
 #define yield()		void()
+// us_ticker_read() / 1000 would wrap after 71 minutes, the kernel count wraps at 2^32 ms like Arduino
+#define millis()	((uint32_t) Kernel::get_ms_count())
+#define micros()	us_ticker_read()
 
 /*
  * This is a little Arduino String emulation to keep the OLEDDisplay
@@ -57,6 +60,43 @@ private:
 	const char *_str;
 };
 
+#elif __linux__
+/*
+ * Host builds, e.g. to run the library against tools/emulator. Fonts are
+ * plain arrays and there is no Print class, the display can't print().
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define pgm_read_byte(addr)   (*(const unsigned char *)(addr))
+#define pgm_read_word(addr)   (*(const uint16_t *)(addr))
+#define delay(x)	std::this_thread::sleep_for(std::chrono::milliseconds(x))
+#define yield()		void()
+#define micros()	((uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())
+#define millis()	(micros() / 1000)
+#define NO_GLOBAL_SERIAL
+
+class String {
+public:
+	String(const char *s) { _str = s; };
+	int length() const { return strlen(_str); };
+	const char *c_str() const { return _str; };
+    void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const {
+		memcpy(buf, _str + index,  std::min((size_t)bufsize, strlen(_str)));
+	};
+private:
+	const char *_str;
+};
+
 #else
 #error "Unkown operating system"
 #endif
@@ -70,7 +110,7 @@ private:
 #define DEBUG_OLEDDISPLAY(...)
 #endif
 
-// Use DOUBLE BUFFERING by default
+// Use DOUBLE BUFFERING by default, see init() to choose per display
 #ifndef OLEDDISPLAY_REDUCE_MEMORY
 #define OLEDDISPLAY_DOUBLE_BUFFER
 #endif
@@ -88,6 +128,34 @@ private:
 #define FIRST_CHAR_POS 2
 #define CHAR_NUM_POS 3
 
+// Sparse fonts have FONT_SPARSE as first char, CHAR_NUM_POS is the number of
+// glyphs in the jump table. The range table maps code points to jump table
+// entries, ranges are ordered by first code point.
+#define FONT_SPARSE 0xFFFF
+#define RANGE_NUM_POS 4
+#define RANGETABLE_START 5
+#define RANGETABLE_BYTES 4
+
+#define RANGETABLE_FIRST_HIGH 0
+#define RANGETABLE_FIRST_LOW  1
+#define RANGETABLE_COUNT      2
+#define RANGETABLE_GLYPH      3
+
+// Fonts with FONT_RLE set in the width word have RLE compressed glyph data,
+// packed two bytes per word (low byte first). The jump table holds the byte
+// offset of the compressed data and the size unpacked. A control byte c is
+// followed by c + 1 literal bytes, or if bit 7 is set, by one byte that is
+// repeated (c & 0x7F) + 1 times.
+#define FONT_RLE 0x8000
+
+// Fonts with FONT_METRICS set in the width word have the width of the bitmap in
+// the jump table. After the jump table follows a word for every entry with the
+// advance (low byte) and the signed left bearing (high byte), then the number
+// of kerning pairs and the pairs: left glyph, right glyph (jump table indices)
+// and the signed adjustment, ordered by left and then right glyph.
+#define FONT_METRICS 0x4000
+#define KERNING_BYTES 3
+
 
 // Display commands
 #define CHARGEPUMP 0x8D
@@ -116,6 +184,13 @@ private:
 #define SETSTARTLINE 0x40
 #define SETVCOMDETECT 0xDB
 #define SWITCHCAPVCC 0x2
+#define RIGHTHORIZONTALSCROLL 0x26
+#define LEFTHORIZONTALSCROLL 0x27
+#define VERTICALRIGHTHORIZONTALSCROLL 0x29
+#define VERTICALLEFTHORIZONTALSCROLL 0x2A
+#define DEACTIVATESCROLL 0x2E
+#define ACTIVATESCROLL 0x2F
+#define SETVERTICALSCROLLAREA 0xA3
 
 #ifndef _swap_int16_t
 #define _swap_int16_t(a, b) { int16_t t = a; a = b; b = t; }
@@ -143,19 +218,164 @@ enum OLEDDISPLAY_GEOMETRY {
   GEOMETRY_RAWMODE  = 4
 };
 
+enum OLEDDISPLAY_SCROLL_DIRECTION {
+  SCROLL_RIGHT = 0,
+  SCROLL_LEFT = 1
+};
+
+// Time between two scroll steps, in frames. The values are the
+// interval codes expected by the SSD1306.
+enum OLEDDISPLAY_SCROLL_SPEED {
+  SCROLL_FRAMES_2   = 0x07,
+  SCROLL_FRAMES_3   = 0x04,
+  SCROLL_FRAMES_4   = 0x05,
+  SCROLL_FRAMES_5   = 0x00,
+  SCROLL_FRAMES_25  = 0x06,
+  SCROLL_FRAMES_64  = 0x01,
+  SCROLL_FRAMES_128 = 0x02,
+  SCROLL_FRAMES_256 = 0x03
+};
+
+enum OLEDDISPLAY_BUFFERING {
+  BUFFERING_DEFAULT,  // double buffering unless OLEDDISPLAY_REDUCE_MEMORY is defined
+  BUFFERING_SINGLE,   // display() sends the whole buffer
+  BUFFERING_DOUBLE    // display() only sends the changes, needs a second buffer
+};
+
 enum HW_I2C {
   I2C_ONE,
   I2C_TWO
 };
 
-typedef char (*FontTableLookupFunction)(const uint8_t ch);
-char DefaultFontTableLookup(const uint8_t ch);
+// Last, smallest, largest and average value of a frame statistic
+struct OLEDDisplayStatValue {
+  uint32_t last;
+  uint32_t min;
+  uint32_t max;
+  uint32_t avg;
+  uint64_t total;
+};
+
+// Statistics of the frames sent by display(), see setFrameStats()
+struct OLEDDisplayFrameStats {
+  uint32_t              frames;        // display() calls since setFrameStats()
+  OLEDDisplayStatValue  dirtyBytes;    // bytes in the changed area
+  OLEDDisplayStatValue  pages;         // pages sent
+  OLEDDisplayStatValue  transactions;  // bus transactions of the transfer
+  OLEDDisplayStatValue  busBytes;      // bytes sent, with control bytes, without addressing
+  OLEDDisplayStatValue  diffTime;      // us comparing the buffer with the back buffer
+  OLEDDisplayStatValue  transferTime;  // us sending the changes
+  OLEDDisplayStatValue  drawTime;      // us between the end of the last display() and this one
+};
+
+// Remembered result of getStringWidth(), see setStringWidthCache()
+struct OLEDDisplayWidthCacheEntry {
+  uint32_t hash;     // FNV-1a of the text and the utf8 flag, selects the entry
+  uint32_t check;    // second, independent hash of the text, both have to match
+  uint16_t length;
+  uint16_t width;
+};
+
+// A line of an OLEDDisplayTextLayout
+struct OLEDDisplayTextLine {
+  uint16_t start;    // offset of the first byte in the text
+  uint16_t length;   // bytes, without the line break
+  uint16_t width;    // pixels
+};
+
+// Text wrapped once by layoutText() and drawn by drawTextLayout() without measuring it again
+class OLEDDisplayTextLayout {
+  public:
+    OLEDDisplayTextLayout(): text(NULL), lines(NULL), lineCount(0), lineHeight(0), font(NULL), textScale(1) {};
+    ~OLEDDisplayTextLayout() { clear(); };
+
+    // Frees the text and the lines
+    void clear();
+
+    // Height of all lines in pixels
+    uint32_t getHeight() const { return (uint32_t) lineCount * lineHeight; };
+
+    char                *text;        // copy of the text
+    OLEDDisplayTextLine *lines;
+    uint16_t             lineCount;
+    uint16_t             lineHeight;  // of the font
+    const uint16_t      *font;        // the text was wrapped with
+    uint8_t              textScale;   // the text was wrapped with
+
+  private:
+    OLEDDisplayTextLayout(const OLEDDisplayTextLayout &);
+    OLEDDisplayTextLayout &operator=(const OLEDDisplayTextLayout &);
+};
+
+// Chars of drawNumber() and drawFixed(), their glyphs are looked up once per font
+#define OLEDDISPLAY_DIGIT_CHARS "0123456789-.,:"
+#define OLEDDISPLAY_DIGIT_COUNT 14
+
+// Longest text of drawNumber() and drawFixed(): sign, 10 digits and the point
+#define OLEDDISPLAY_NUMBER_LENGTH 12
+
+// Jump table entry and metrics of a char of OLEDDISPLAY_DIGIT_CHARS
+struct OLEDDisplayDigitGlyph {
+  int16_t  index;      // in the jump table, -1 if the font doesn't have the char
+  uint16_t position;   // of the glyph data, 0xFFFF if there is no bitmap
+  uint16_t size;       // of the glyph data
+  uint8_t  width;      // of the bitmap
+  uint8_t  advance;
+  int8_t   bearing;
+};
+
+// What drawNumber() or drawFixed() drew last at a place, lets the next call clear
+// the old number and only redraw the chars that changed
+struct OLEDDisplayNumberCache {
+  char            text[OLEDDISPLAY_NUMBER_LENGTH];
+  uint8_t         length;    // 0: nothing drawn yet
+  int16_t         x;         // of the text after the alignment
+  int16_t         y;
+  int16_t         left;      // pixels covered, relative to x
+  int16_t         right;
+  uint16_t        height;
+  const uint16_t *font;
+  uint8_t         scale;
+};
+
+enum OLEDDISPLAY_TRACE {
+  TRACE_COMMAND,  // a command byte
+  TRACE_DATA,     // display RAM data
+  TRACE_FRAME     // end of a display(), no bytes
+};
+
+// Receives everything a display sends to the controller, see setTraceSink()
+class OLEDDisplayTraceSink {
+  public:
+    virtual ~OLEDDisplayTraceSink() {};
+
+    // Called by setTraceSink() with the size of the display
+    virtual void begin(uint16_t width, uint16_t height) {(void)width; (void)height;};
+
+    // Called for every command byte and block of data sent, in the order sent
+    virtual void trace(OLEDDISPLAY_TRACE type, const uint8_t *bytes, uint16_t length) = 0;
+};
+
+// Maps a code point to the character code of the font, 0 if the font can't
+// show it. Only called for code points from 0x80 on, ASCII goes to the font as is
+typedef uint32_t (*FontTableLookupFunction)(const uint32_t codePoint);
+uint32_t DefaultFontTableLookup(const uint32_t codePoint);
+
+// Decodes the UTF-8 sequence at text[*index], moves *index past it and returns
+// the code point. Malformed or truncated sequences consume one byte and return
+// 0xFFFD. Keeps no state, so it is safe to use from several tasks at once.
+uint32_t Utf8Decode(const char *text, uint16_t length, uint16_t *index);
+
+// Number of ASCII bytes at the start of text, checked four bytes at a time
+uint16_t Utf8AsciiLength(const char *text, uint16_t length);
 
 
 #ifdef ARDUINO
 class OLEDDisplay : public Print  {
 #elif __MBED__
 class OLEDDisplay : public Stream {
+#elif __linux__
+class OLEDDisplay {
 #else
 #error "Unkown operating system"
 #endif
@@ -172,8 +392,13 @@ class OLEDDisplay : public Stream {
     bool allocateBuffer();
 
     // Allocates the buffer and initializes the driver & display. Resets the display!
+    // With BUFFERING_SINGLE the display uses half the memory but display() always
+    // sends the whole buffer, worth it for displays that rarely change.
     // Returns false if buffer allocation failed, true otherwise.
-    bool init();
+    bool init(OLEDDISPLAY_BUFFERING buffering = BUFFERING_DEFAULT);
+
+    // Returns true if the display only sends the changes (double buffering)
+    bool isDoubleBuffered() const { return doubleBuffered; };
 
     // Free the memory used by the display
     void end();
@@ -240,6 +465,21 @@ class OLEDDisplay : public Stream {
     // Draw icon 16x16 xbm format
     void drawIco16x16(int16_t x, int16_t y, const uint8_t *ico, bool inverse = false);
 
+    // Draw a RAM buffer that uses the layout of the display buffer (one byte per column and
+    // 8 pixel high page, pages stored one after another) e.g. an off-screen snapshot
+    void drawPageBuffer(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *pages);
+
+    // Draw the width x height window at srcX, srcY of a page buffer that is pagesWidth x pagesHeight
+    // pixels, the window can start at any row. Used to scroll through content rendered off-screen
+    void drawPageBuffer(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *pages,
+                        uint16_t pagesWidth, uint16_t pagesHeight, uint16_t srcX, uint16_t srcY);
+
+    // Draw into a page buffer of the given size instead of the display buffer, e.g. to render
+    // text once and show it with drawPageBuffer() every frame. NULL draws into the display again.
+    // buffer, width() and height() stay those of the display, so a frame OLEDDisplayPipeline
+    // or OLEDDisplayManager is sending meanwhile is not affected.
+    void setDrawTarget(uint8_t *pages, uint16_t width = 0, uint16_t height = 0);
+
     /* Text functions */
 
     // Draws a string at the given location, returns how many chars have been written
@@ -255,6 +495,26 @@ class OLEDDisplay : public Stream {
     // first line if not
     uint16_t drawStringMaxWidth(int16_t x, int16_t y, uint16_t maxLineWidth, const String &text);
 
+    // Draws an integer with at least minDigits (up to 10) digits, zero padded, with the current font,
+    // alignment and color, without building a string. Returns the width in pixels.
+    // With a cache the number drawn last there is cleared first and chars that didn't change
+    // are not drawn again. Keep the display buffer between the calls then (no clear()).
+    uint16_t drawNumber(int16_t x, int16_t y, int32_t value, uint8_t minDigits = 1, OLEDDisplayNumberCache *cache = NULL);
+
+    // Draws value / 10^decimals with all decimals (up to 9) like drawNumber(), e.g. 2315
+    // with 2 decimals shows 23.15. point can be '.', ',' or ':'
+    uint16_t drawFixed(int16_t x, int16_t y, int32_t value, uint8_t decimals, char point = '.', OLEDDisplayNumberCache *cache = NULL);
+
+    // Wraps the text with the current font like drawStringMaxWidth() and keeps a copy
+    // of it with the start, length and width of every line in layout.
+    // Returns false if there is not enough memory.
+    bool layoutText(OLEDDisplayTextLayout *layout, const String &text, uint16_t maxLineWidth);
+
+    // Draws the lines of a layout that are visible in the height pixels from y on,
+    // scrollY pixels down into the text. height 0 is the rest of the display. Lines cut
+    // by the window are drawn whole. Switches to the font and text scale of the layout.
+    void drawTextLayout(int16_t x, int16_t y, const OLEDDisplayTextLayout *layout, uint32_t scrollY = 0, uint16_t height = 0);
+
     // Returns the width of the const char* with the current
     // font settings
     uint16_t getStringWidth(const char* text, uint16_t length, bool utf8 = false);
@@ -266,6 +526,12 @@ class OLEDDisplay : public Stream {
     // the text is rendered. Available constants:
     // TEXT_ALIGN_LEFT, TEXT_ALIGN_CENTER, TEXT_ALIGN_RIGHT, TEXT_ALIGN_CENTER_BOTH
     void setTextAlignment(OLEDDISPLAY_TEXT_ALIGNMENT textAlignment);
+    OLEDDISPLAY_TEXT_ALIGNMENT getTextAlignment() const { return textAlignment; };
+
+    // Draws text scale (1..4) times as big, every pixel of the font becomes a
+    // scale x scale block. Big digits don't need a big font that way. 1 (default) is the font size.
+    // print() always uses the font size.
+    void setTextScale(uint8_t scale);
 
     // Sets the current font. Available default fonts
     // ArialMT_Plain_10, ArialMT_Plain_16, ArialMT_Plain_24
@@ -274,9 +540,19 @@ class OLEDDisplay : public Stream {
     // Set the current font when supplied as a char* instead of a uint8_t*
     void setFont(const char *fontData);
 
-    // Set the function that will convert utf-8 to font table index
+    // Returns the current font
+    const uint16_t *getFont() const { return fontData; };
+
+    // Set the function that maps code points of the text to font table index
     void setFontTableLookupFunction(FontTableLookupFunction function);
 
+    // Remember the widths of up to entries strings measured with the current
+    // font, 0 (default) turns it off. Measuring a text again, e.g. a right aligned
+    // label each frame, then costs hashing the text instead of a width lookup and
+    // kerning per char, still a pass over the text. Returns false if there is not
+    // enough memory.
+    bool setStringWidthCache(uint8_t entries);
+
     /* Display functions */
 
     // Turn the display on
@@ -308,8 +584,54 @@ class OLEDDisplay : public Stream {
     // Mirror the display (to be used in a mirror or as a projector)
     void mirrorScreen();
 
+    /* Hardware scrolling (SSD1306 only, does nothing on other controllers) */
+
+    // Let the controller continuously scroll the pages startPage..endPage
+    // horizontally. Costs no CPU and no bus traffic once started.
+    // While scrolling display() is deferred, the panel RAM must not be written.
+    void startScrollHorizontal(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                               OLEDDISPLAY_SCROLL_SPEED speed = SCROLL_FRAMES_2);
+
+    // Scroll pages startPage..endPage horizontally and the rows of the vertical
+    // scroll area up by verticalOffset rows per step. The vertical scroll area
+    // starts after fixedRows rows and spans scrollRows rows (0 = rest of the screen).
+    void startScrollDiagonal(OLEDDISPLAY_SCROLL_DIRECTION direction, uint8_t startPage, uint8_t endPage,
+                             uint8_t verticalOffset, OLEDDISPLAY_SCROLL_SPEED speed = SCROLL_FRAMES_2,
+                             uint8_t fixedRows = 0, uint8_t scrollRows = 0);
+
+    // Stop scrolling and restore the local buffer on the display, the
+    // controller leaves its RAM shifted when scrolling is deactivated.
+    void stopScroll();
+
+    // Returns true while the controller is scrolling
+    bool isScrolling() const { return scrolling; };
+
     // Write the buffer to the display memory
-    virtual void display(void) = 0;
+    virtual void display(void);
+
+    // Exchange buffer and buffer_back after display() instead of copying the
+    // sent frame into buffer_back byte by byte. buffer then holds an older frame,
+    // so clear() and redraw everything before each display(). Doesn't work with
+    // code that draws on top of the last frame (widgets, print). Needs
+    // double buffering.
+    void setBufferSwap(bool swap);
+    bool isBufferSwap() const { return bufferSwap; };
+
+    // Collect statistics about every frame sent in the given struct, which is
+    // reset. NULL (default) stops collecting.
+    void setFrameStats(OLEDDisplayFrameStats *stats);
+
+    // Pass every command and data byte sent to the display to sink, NULL stops tracing.
+    // The sink first gets the addressing mode init() sets, so it can start after init().
+    void setTraceSink(OLEDDisplayTraceSink *sink);
+
+    // Send the buffer in steps instead of all at once with display(), used to
+    // share a bus between displays. beginTransfer() determines the changed area
+    // and returns false if there is nothing to send, every transferNext() sends
+    // one page of it and returns true while pages are left.
+    // With frame != NULL that frame (same size as buffer) is sent instead of buffer.
+    bool beginTransfer(uint8_t *frame = NULL);
+    bool transferNext();
 
     // Clear the local pixel buffer
     void clear(void);
@@ -334,6 +656,15 @@ class OLEDDisplay : public Stream {
     // (Automatically called with you use print, println or printf)
     void drawLogBuffer(uint16_t x, uint16_t y);
 
+    // Coalesce the redraws triggered by print, println and printf. With an
+    // interval > 0 the screen is refreshed at most once every `interval` ms,
+    // writes in between only mark the console dirty. Call flush() to push
+    // pending text to the display. 0 (default) redraws on every write.
+    void setLogBufferRedrawInterval(uint16_t interval);
+
+    // Redraw the log buffer now if there are writes not yet shown
+    void flush();
+
     // Get screen geometry
     uint16_t getWidth(void);
     uint16_t getHeight(void);
@@ -341,6 +672,7 @@ class OLEDDisplay : public Stream {
     // Implement needed function to be compatible with Print class
     size_t write(uint8_t c);
     size_t write(const char* s);
+    size_t write(const uint8_t* buffer, size_t size);
 
     // Implement needed function to be compatible with Stream class
 #ifdef __MBED__
@@ -351,11 +683,12 @@ class OLEDDisplay : public Stream {
 
     uint8_t            *buffer;
 
-    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    // NULL with single buffering
     uint8_t            *buffer_back;
-    #endif
 
   protected:
+    // Allocates the buffers it swaps in with BufferOffset
+    friend class OLEDDisplayPipeline;
 
     OLEDDISPLAY_GEOMETRY geometry;
 
@@ -363,14 +696,63 @@ class OLEDDisplay : public Stream {
     uint16_t  displayHeight;
     uint16_t  displayBufferSize;
 
+    // Page buffer set by setDrawTarget() and its size, NULL draws into buffer. Only the
+    // drawing functions use it, the transfer path may run on another task meanwhile.
+    uint8_t  *drawTarget;
+    uint16_t  drawTargetWidth;
+    uint16_t  drawTargetHeight;
+    uint16_t  drawTargetSize;
+
+    uint8_t  *drawBuffer() const { return drawTarget ? drawTarget : buffer; };
+    uint16_t  drawWidth() const { return drawTarget ? drawTargetWidth : displayWidth; };
+    uint16_t  drawHeight() const { return drawTarget ? drawTargetHeight : displayHeight; };
+    uint16_t  drawBufferSize() const { return drawTarget ? drawTargetSize : displayBufferSize; };
+
+    bool      scrolling;
+    bool      doubleBuffered;
+    bool      bufferSwap;
+
+    OLEDDisplayTraceSink *traceSink;
+
+    // Statistics of the current frame, only collected with frameStats set
+    OLEDDisplayFrameStats *frameStats;
+    uint32_t  frameDiffTime;
+    uint32_t  frameTransferTime;
+    uint32_t  frameDrawTime;
+    uint32_t  frameEnd;
+    uint16_t  frameTransactions;
+    uint32_t  frameBusBytes;
+
+    // Frame and area of the transfer started by beginTransfer() and the next page to send
+    uint8_t  *transferFrame;
+    uint16_t  transferMinX;
+    uint16_t  transferMaxX;
+    uint8_t   transferMinPage;
+    uint8_t   transferMaxPage;
+    uint8_t   transferPage;
+
     // Set the correct height, width and buffer for the geometry
     void setGeometry(OLEDDISPLAY_GEOMETRY g, uint16_t width = 0, uint16_t height = 0);
 
     OLEDDISPLAY_TEXT_ALIGNMENT   textAlignment;
+    uint8_t                      textScale;
     OLEDDISPLAY_COLOR            color;
 
     const uint16_t	 *fontData;
 
+    // Widths of the chars 0..255 of the current font, built on first use after
+    // setFont(). Not used with OLEDDISPLAY_REDUCE_MEMORY.
+    uint8_t   *fontWidths;
+    bool      fontWidthsValid;
+
+    // Glyphs of OLEDDISPLAY_DIGIT_CHARS of the current font, read on first use after setFont()
+    OLEDDisplayDigitGlyph digitGlyphs[OLEDDISPLAY_DIGIT_COUNT];
+    bool      digitGlyphsValid;
+
+    // Widths of recently measured strings, see setStringWidthCache()
+    OLEDDisplayWidthCacheEntry *widthCache;
+    uint8_t   widthCacheSize;
+
     // State values for logBuffer
     uint16_t   logBufferSize;
     uint16_t   logBufferFilled;
@@ -379,6 +761,9 @@ class OLEDDisplay : public Stream {
     uint16_t   logBufferLineLen;
     char      *logBuffer;
     bool      inhibitDrawLogBuffer;
+    bool      logBufferDirty;
+    uint16_t  logBufferRedrawInterval;
+    uint32_t  logBufferLastRedraw;
 
 
 	// the header size of the buffer used, e.g. for the SPI command header
@@ -388,6 +773,29 @@ class OLEDDisplay : public Stream {
     // Send a command to the display (low level function)
     virtual void sendCommand(uint8_t com) {(void)com;};
 
+    // Called after the last page of a transfer, makes the sent frame the back buffer
+    void finishTransfer(uint16_t dirtyBytes, uint8_t pages);
+
+    // Drivers report every command they send, data is traced by transferNext()
+    void traceCommand(uint8_t command) {
+      if (traceSink) traceSink->trace(TRACE_COMMAND, &command, 1);
+    };
+
+    // Drivers report every bus transaction with the number of bytes sent
+    void countBusTransaction(uint16_t bytes) {
+      if (frameStats) {
+        frameTransactions++;
+        frameBusBytes += bytes;
+      }
+    };
+
+    // Send the columns minX..maxX of a page to the display (low level function),
+    // the pages of a transfer are sent in order transferMinPage..transferMaxPage
+    virtual void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {(void)page; (void)minX; (void)maxX;};
+
+    // False for controllers without the SSD1306 scroll commands, startScroll*() does nothing then
+    virtual bool supportsHardwareScroll() { return true; };
+
     // Connect to the display
     virtual bool connect() { return false; };
 
@@ -397,10 +805,51 @@ class OLEDDisplay : public Stream {
     // converts utf8 characters to extended ascii
     char* utf8ascii(const String &s);
 
-    void inline drawInternal(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint16_t *data, uint16_t offset, uint16_t bytesInData) __attribute__((always_inline));
+    void inline drawInternal(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint16_t *data, uint16_t offset, uint16_t bytesInData, bool compressed = false) __attribute__((always_inline));
+
+    // drawInternal() for text scaled by 2..4, see setTextScale()
+    void drawInternalScaled(int16_t xMove, int16_t yMove, int16_t width, int16_t height, const uint16_t *data, uint16_t offset, uint16_t bytesInData, bool compressed, uint8_t scale);
 
     uint16_t drawStringInternal(int16_t xMove, int16_t yMove, const char* text, uint16_t textLength, uint16_t textWidth, bool utf8);
 
+    // Finds where drawStringMaxWidth() wraps the first line of the text, returns the
+    // start of the next line. The line is lineLength bytes and lineWidth pixels
+    uint16_t getLineBreak(const char* text, uint16_t length, uint16_t maxLineWidth, uint16_t *lineLength, uint16_t *lineWidth);
+
+    // Draws the chars of OLEDDISPLAY_DIGIT_CHARS in text for drawNumber() and drawFixed()
+    uint16_t drawDigits(int16_t xMove, int16_t yMove, const char *text, uint8_t length, OLEDDisplayNumberCache *cache);
+
+    // Width of a character of the current font, 0 if the font doesn't have it
+    uint16_t getCharWidth(uint32_t code);
+
+    // Same as getCharWidth() but always read from the font
+    uint16_t readCharWidth(uint32_t code);
+
+    // The width table of the current font, NULL if there is none
+    const uint8_t *getFontWidths();
+
+    // Jump table entry of a character of the current font, -1 if the font doesn't have it
+    int32_t getGlyphIndex(uint32_t code);
+
+    // Position of the jump table in the current font
+    uint16_t getJumpTableStart();
+
+    // Advance and bearing of every glyph of the current font, NULL if it has none
+    const uint16_t *getFontMetrics();
+
+    // Kerning pairs of the current font, NULL if it has none
+    const uint16_t *getKerningPairs(uint16_t *count);
+
+    // Start of the glyph data of the current font
+    const uint16_t *getCharData();
+
+    // Adjustment between two glyphs (jump table entries) from the kerning pairs
+    int16_t getKerning(const uint16_t *pairs, uint16_t count, int32_t left, int32_t right);
+
+    // Character of the current font for a code point from 0x80 on, 0 to drop it.
+    // Sparse fonts are indexed by code point, others use the lookup function
+    uint32_t getFontCode(uint32_t codePoint);
+
     // (re)creates the logBuffer that printing uses to remember what was on the
     // screen already 
     bool setLogBuffer();
@@ -408,6 +857,10 @@ class OLEDDisplay : public Stream {
     // Draws the contents of the logBuffer to the screen
     void drawLogBuffer();
 
+    // Pushes the logBuffer to the display, unless the redraw interval
+    // has not elapsed yet and force is false
+    void redrawLogBuffer(bool force);
+
 	FontTableLookupFunction fontTableLookupFunction;
 };
 
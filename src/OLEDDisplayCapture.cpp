@@ -0,0 +1,81 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#include "OLEDDisplayCapture.h"
+
+#ifdef ARDUINO
+
+OLEDDisplayCapture::OLEDDisplayCapture(Print *out) {
+  this->out = out;
+  this->lastRecord = 0;
+  this->captureSize = 0;
+}
+
+void OLEDDisplayCapture::begin(uint16_t width, uint16_t height) {
+  uint8_t header[9] = {'O', 'L', 'E', 'D', OLEDDISPLAYCAPTURE_VERSION,
+    (uint8_t) (width & 0xFF), (uint8_t) (width >> 8), (uint8_t) (height & 0xFF), (uint8_t) (height >> 8)};
+  this->out->write(header, sizeof(header));
+  this->captureSize = sizeof(header);
+  this->lastRecord = micros();
+}
+
+void OLEDDisplayCapture::trace(OLEDDISPLAY_TRACE type, const uint8_t *bytes, uint16_t length) {
+  uint32_t now = micros();
+  switch (type) {
+    case TRACE_COMMAND: this->out->write((uint8_t) 1); break;
+    case TRACE_DATA:    this->out->write((uint8_t) 2); break;
+    case TRACE_FRAME:   this->out->write((uint8_t) 3); break;
+  }
+  this->captureSize++;
+  writeNumber(now - this->lastRecord);
+  this->lastRecord = now;
+
+  if (type == TRACE_COMMAND) {
+    this->out->write(bytes[0]);
+    this->captureSize++;
+  } else if (type == TRACE_DATA) {
+    writeNumber(length);
+    this->out->write(bytes, length);
+    this->captureSize += length;
+  }
+}
+
+void OLEDDisplayCapture::writeNumber(uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value) byte |= 0x80;
+    this->out->write(byte);
+    this->captureSize++;
+  } while (value);
+}
+
+#endif
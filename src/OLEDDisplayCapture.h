@@ -0,0 +1,73 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef OLEDDISPLAYCAPTURE_h
+#define OLEDDISPLAYCAPTURE_h
+
+#include "OLEDDisplay.h"
+
+#ifdef ARDUINO
+
+#define OLEDDISPLAYCAPTURE_VERSION 1
+
+/**
+ * Writes everything a display sends in a compact binary format to a Print
+ * (Serial, a file, ...). tools/oledreplay rebuilds the display RAM from it.
+ *
+ * Header:  'O' 'L' 'E' 'D' version width height  (width, height: 16 bit little endian)
+ * Records: type  time
+ *          type 1 (command): time, the command byte
+ *          type 2 (data):    time, length, the data bytes
+ *          type 3 (frame):   time, marks the end of a display()
+ * time is the number of microseconds since the previous record, time and
+ * length are unsigned LEB128 numbers (7 bits per byte, lowest first).
+ */
+class OLEDDisplayCapture : public OLEDDisplayTraceSink {
+  public:
+    OLEDDisplayCapture(Print *out);
+
+    void begin(uint16_t width, uint16_t height);
+    void trace(OLEDDISPLAY_TRACE type, const uint8_t *bytes, uint16_t length);
+
+    // Number of bytes written since begin()
+    uint32_t getCaptureSize() const { return captureSize; };
+
+  private:
+    void writeNumber(uint32_t value);
+
+    Print     *out;
+    uint32_t   lastRecord;
+    uint32_t   captureSize;
+};
+
+#endif
+
+#endif
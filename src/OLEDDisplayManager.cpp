@@ -0,0 +1,138 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#include "OLEDDisplayManager.h"
+
+OLEDDisplayManager::OLEDDisplayManager() {
+  this->displayCount = 0;
+#if defined(ARDUINO_ARCH_ESP32)
+  this->workerCount = 0;
+#endif
+}
+
+OLEDDisplayManager::~OLEDDisplayManager() {
+#if defined(ARDUINO_ARCH_ESP32)
+  for (uint8_t i = 0; i < this->workerCount; i++) {
+    vTaskDelete(this->workers[i].task);
+    vSemaphoreDelete(this->workers[i].done);
+  }
+#endif
+}
+
+bool OLEDDisplayManager::add(OLEDDisplay *display, uint8_t bus) {
+  if (this->displayCount >= OLEDDISPLAY_MANAGER_MAX_DISPLAYS) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDDisplayManager] Too many displays\n");
+    return false;
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  bool newBus = this->displayCount > 0 && bus != this->buses[0];
+  for (uint8_t i = 0; i < this->workerCount && newBus; i++) {
+    newBus = this->workers[i].bus != bus;
+  }
+  if (newBus) {
+    BusWorker *worker = &this->workers[this->workerCount];
+    worker->manager = this;
+    worker->bus = bus;
+    worker->done = xSemaphoreCreateBinary();
+    if (!worker->done) {
+      DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDDisplayManager] Not enough memory to create bus task\n");
+      return false;
+    }
+    if (xTaskCreate(busTask, "OLEDDisplayBus", OLEDDISPLAY_MANAGER_STACK, worker, uxTaskPriorityGet(NULL), &worker->task) != pdPASS) {
+      DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDDisplayManager] Not enough memory to create bus task\n");
+      vSemaphoreDelete(worker->done);
+      return false;
+    }
+    this->workerCount++;
+  }
+#endif
+
+  this->displays[this->displayCount] = display;
+  this->buses[this->displayCount] = bus;
+  this->pending[this->displayCount] = false;
+  this->displayCount++;
+  return true;
+}
+
+bool OLEDDisplayManager::init() {
+  bool success = true;
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    success &= this->displays[i]->init();
+  }
+  return success;
+}
+
+void OLEDDisplayManager::display() {
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    this->pending[i] = this->displays[i]->beginTransfer();
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  for (uint8_t i = 0; i < this->workerCount; i++) {
+    xTaskNotifyGive(this->workers[i].task);
+  }
+  if (this->displayCount > 0) {
+    transferBus(this->buses[0]);
+  }
+  for (uint8_t i = 0; i < this->workerCount; i++) {
+    xSemaphoreTake(this->workers[i].done, portMAX_DELAY);
+  }
+#else
+  // One bus at a time, the transfers block anyway
+  for (uint8_t i = 0; i < this->displayCount; i++) {
+    if (this->pending[i]) transferBus(this->buses[i]);
+  }
+#endif
+}
+
+void OLEDDisplayManager::transferBus(uint8_t bus) {
+  bool sending = true;
+  while (sending) {
+    sending = false;
+    for (uint8_t i = 0; i < this->displayCount; i++) {
+      if (this->buses[i] != bus || !this->pending[i]) continue;
+      this->pending[i] = this->displays[i]->transferNext();
+      sending |= this->pending[i];
+    }
+  }
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void OLEDDisplayManager::busTask(void *parameter) {
+  BusWorker *worker = (BusWorker *) parameter;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    worker->manager->transferBus(worker->bus);
+    xSemaphoreGive(worker->done);
+  }
+}
+#endif
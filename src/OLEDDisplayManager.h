@@ -0,0 +1,96 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef OLEDDISPLAYMANAGER_h
+#define OLEDDISPLAYMANAGER_h
+
+#include "OLEDDisplay.h"
+
+#ifndef OLEDDISPLAY_MANAGER_MAX_DISPLAYS
+#define OLEDDISPLAY_MANAGER_MAX_DISPLAYS 4
+#endif
+
+// Stack size of the ESP32 bus tasks in bytes, drivers and trace sinks run on them
+#ifndef OLEDDISPLAY_MANAGER_STACK
+#define OLEDDISPLAY_MANAGER_STACK 4096
+#endif
+
+/**
+ * Sends the changes of several displays in one go. Displays on the same bus
+ * take turns page by page, so one display with a lot of changes doesn't hold
+ * back the others. On ESP32 every further bus is served by its own task,
+ * displays on different buses (e.g. I2C_ONE and I2C_TWO) are then written at
+ * the same time.
+ */
+class OLEDDisplayManager {
+  public:
+    OLEDDisplayManager();
+    ~OLEDDisplayManager();
+
+    // Add a display, displays with the same bus number share a bus.
+    // Returns false if OLEDDISPLAY_MANAGER_MAX_DISPLAYS displays were already added.
+    bool add(OLEDDisplay *display, uint8_t bus = 0);
+
+    // Initialize all displays
+    bool init();
+
+    uint8_t getDisplayCount() const { return displayCount; };
+    OLEDDisplay *getDisplay(uint8_t index) { return index < displayCount ? displays[index] : NULL; };
+
+    // Write the buffers of all displays to the display memory
+    void display();
+
+  private:
+    // Send the pending pages of all displays on a bus, alternating between the displays
+    void transferBus(uint8_t bus);
+
+    OLEDDisplay *displays[OLEDDISPLAY_MANAGER_MAX_DISPLAYS];
+    uint8_t      buses[OLEDDISPLAY_MANAGER_MAX_DISPLAYS];
+    bool         pending[OLEDDISPLAY_MANAGER_MAX_DISPLAYS];
+    uint8_t      displayCount;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    struct BusWorker {
+      OLEDDisplayManager *manager;
+      uint8_t             bus;
+      TaskHandle_t        task;
+      SemaphoreHandle_t   done;
+    };
+
+    static void busTask(void *parameter);
+
+    // Tasks for all buses but the one of the first display
+    BusWorker    workers[OLEDDISPLAY_MANAGER_MAX_DISPLAYS];
+    uint8_t      workerCount;
+#endif
+};
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#include "OLEDDisplayPipeline.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#define OLEDDISPLAY_PIPELINE_IDLE BIT0
+#endif
+
+OLEDDisplayPipeline::OLEDDisplayPipeline(OLEDDisplay *display) {
+  this->oled = display;
+  this->frame = NULL;
+  this->frameSize = 0;
+#if defined(ARDUINO_ARCH_ESP32) || defined(__linux__)
+  this->pending = false;
+  this->running = false;
+#endif
+#if defined(ARDUINO_ARCH_ESP32)
+  this->task = NULL;
+  this->events = NULL;
+#endif
+}
+
+OLEDDisplayPipeline::~OLEDDisplayPipeline() {
+  end();
+}
+
+bool OLEDDisplayPipeline::begin() {
+#if defined(ARDUINO_ARCH_ESP32) || defined(__linux__)
+  if (this->running) return true;
+
+  // With swapped buffers the frame becomes a buffer of the display, it needs
+  // the same room for the driver header in front
+  this->frameSize = this->oled->getWidth() * this->oled->getHeight() / 8;
+  this->frame = (uint8_t*) malloc((sizeof(uint8_t) * this->frameSize) + this->oled->BufferOffset);
+  if (!this->frame) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDDisplayPipeline] Not enough memory to create frame\n");
+    return false;
+  }
+  this->frame += this->oled->BufferOffset;
+
+  this->pending = false;
+  this->running = true;
+#if defined(ARDUINO_ARCH_ESP32)
+  this->events = xEventGroupCreate();
+  if (!this->events) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDDisplayPipeline] Not enough memory to create event group\n");
+    this->running = false;
+    free(this->frame - this->oled->BufferOffset);
+    this->frame = NULL;
+    return false;
+  }
+  xEventGroupSetBits(this->events, OLEDDISPLAY_PIPELINE_IDLE);
+
+  // Pin the flush task to the core we are not running on
+  BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+  if (xTaskCreatePinnedToCore(flushTask, "OLEDDisplayFlush", OLEDDISPLAY_PIPELINE_STACK, this, uxTaskPriorityGet(NULL), &this->task, core) != pdPASS) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDDisplayPipeline] Not enough memory to create flush task\n");
+    this->running = false;
+    vEventGroupDelete(this->events);
+    this->events = NULL;
+    free(this->frame - this->oled->BufferOffset);
+    this->frame = NULL;
+    return false;
+  }
+#else
+  this->thread = std::thread([this]() {
+    std::unique_lock<std::mutex> guard(this->lock);
+    for (;;) {
+      this->changed.wait(guard, [this]() { return this->pending || !this->running; });
+      if (!this->pending) break;
+      // The frame belongs to this thread while pending is set
+      guard.unlock();
+      flush();
+      guard.lock();
+      this->pending = false;
+      this->changed.notify_all();
+    }
+  });
+#endif
+#endif
+  return true;
+}
+
+void OLEDDisplayPipeline::end() {
+#if defined(ARDUINO_ARCH_ESP32) || defined(__linux__)
+  if (!this->running) return;
+  waitIdle();
+#if defined(ARDUINO_ARCH_ESP32)
+  this->running = false;
+  vTaskDelete(this->task);
+  this->task = NULL;
+  vEventGroupDelete(this->events);
+  this->events = NULL;
+#else
+  {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->running = false;
+  }
+  this->changed.notify_all();
+  this->thread.join();
+#endif
+  free(this->frame - this->oled->BufferOffset);
+  this->frame = NULL;
+#endif
+}
+
+void OLEDDisplayPipeline::display() {
+#if defined(ARDUINO_ARCH_ESP32) || defined(__linux__)
+  if (this->running) {
+    waitIdle();
+    if (this->oled->isBufferSwap()) {
+      // Hand over the drawn buffer and draw the next frame into the free one
+      uint8_t *drawn = this->oled->buffer;
+      this->oled->buffer = this->frame;
+      this->frame = drawn;
+    } else {
+      memcpy(this->frame, this->oled->buffer, this->frameSize);
+    }
+#if defined(ARDUINO_ARCH_ESP32)
+    xEventGroupClearBits(this->events, OLEDDISPLAY_PIPELINE_IDLE);
+    this->pending = true;
+    xTaskNotifyGive(this->task);
+#else
+    {
+      std::lock_guard<std::mutex> guard(this->lock);
+      this->pending = true;
+    }
+    this->changed.notify_all();
+#endif
+    return;
+  }
+#endif
+  this->oled->display();
+}
+
+bool OLEDDisplayPipeline::isBusy() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return this->pending;
+#elif defined(__linux__)
+  std::lock_guard<std::mutex> guard(this->lock);
+  return this->pending;
+#else
+  return false;
+#endif
+}
+
+void OLEDDisplayPipeline::waitIdle() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (!this->running) return;
+  xEventGroupWaitBits(this->events, OLEDDISPLAY_PIPELINE_IDLE, pdFALSE, pdTRUE, portMAX_DELAY);
+#elif defined(__linux__)
+  std::unique_lock<std::mutex> guard(this->lock);
+  this->changed.wait(guard, [this]() { return !this->pending; });
+#endif
+}
+
+void OLEDDisplayPipeline::flush() {
+#if defined(ARDUINO_ARCH_ESP32) || defined(__linux__)
+  uint8_t *back = this->oled->buffer_back;
+  if (this->oled->beginTransfer(this->frame)) {
+    while (this->oled->transferNext());
+  }
+  // With swapped buffers the frame is now the back buffer, take the old one
+  if (this->oled->buffer_back != back) {
+    this->frame = back;
+  }
+#endif
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void OLEDDisplayPipeline::flushTask(void *parameter) {
+  OLEDDisplayPipeline *pipeline = (OLEDDisplayPipeline *) parameter;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    pipeline->flush();
+    pipeline->pending = false;
+    xEventGroupSetBits(pipeline->events, OLEDDISPLAY_PIPELINE_IDLE);
+  }
+}
+#endif
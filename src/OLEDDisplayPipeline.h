@@ -0,0 +1,115 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef OLEDDISPLAYPIPELINE_h
+#define OLEDDISPLAYPIPELINE_h
+
+#include "OLEDDisplay.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <atomic>
+#include <freertos/event_groups.h>
+#elif defined(__linux__)
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#endif
+
+// Stack size of the ESP32 flush task in bytes, drivers and trace sinks run on it
+#ifndef OLEDDISPLAY_PIPELINE_STACK
+#define OLEDDISPLAY_PIPELINE_STACK 4096
+#endif
+
+/**
+ * Sends the frames of a display from a separate task, so the next frame can be
+ * drawn while the previous one is still on its way over the bus.
+ *
+ * display() copies the buffer into a frame owned by the flush task and returns
+ * right away, it only waits if the previous frame isn't sent yet. On ESP32 the
+ * flush task runs on the other core, on Linux in a std::thread. Other platforms
+ * have no second task, display() then sends the frame itself.
+ *
+ * With display->setBufferSwap(true) nothing is copied: the drawn buffer is
+ * handed over and the display draws into a third buffer, which holds an old
+ * frame, so every frame has to be drawn completely. The third buffer is
+ * allocated with the header of the driver (getBufferOffset()) like the others.
+ *
+ * Don't call display() or other methods that talk to the display (contrast,
+ * scrolling, ...) on the display itself while the pipeline is running.
+ */
+class OLEDDisplayPipeline {
+  public:
+    OLEDDisplayPipeline(OLEDDisplay *display);
+    ~OLEDDisplayPipeline();
+
+    // Allocate the frame and start the flush task, call after display->init()
+    bool begin();
+
+    // Wait for the last frame and stop the flush task
+    void end();
+
+    // Hand the current buffer of the display to the flush task
+    void display();
+
+    // Returns true while a frame is sent
+    bool isBusy();
+
+    // Wait until the last frame is sent
+    void waitIdle();
+
+  private:
+    // Send the frame handed over by display()
+    void flush();
+
+    OLEDDisplay  *oled;
+    uint8_t      *frame;
+    uint16_t      frameSize;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    // true from display() until the flush task has sent the frame, the frame
+    // belongs to the flush task while it is set
+    std::atomic<bool> pending;
+    std::atomic<bool> running;
+    static void flushTask(void *parameter);
+    TaskHandle_t  task;
+    // OLEDDISPLAY_PIPELINE_IDLE is set while no frame is pending
+    EventGroupHandle_t events;
+#elif defined(__linux__)
+    // Same as above, guarded by lock, changed is notified on every change
+    bool          pending;
+    bool          running;
+    std::mutex    lock;
+    std::condition_variable changed;
+    std::thread   thread;
+#endif
+};
+
+#endif
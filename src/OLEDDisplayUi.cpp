@@ -31,6 +31,46 @@
 
 #include "OLEDDisplayUi.h"
 
+// y = x^2
+const uint16_t EASING_easeIn[] PROGMEM = {
+    0,   1,   4,   9,  16,  25,  36,  49,  64,  81, 100, 121, 144, 169, 196, 225, 256
+};
+
+// y = 1 - (1 - x)^2
+const uint16_t EASING_easeOut[] PROGMEM = {
+    0,  31,  60,  87, 112, 135, 156, 175, 192, 207, 220, 231, 240, 247, 252, 255, 256
+};
+
+// y = 3x^2 - 2x^3
+const uint16_t EASING_easeInOut[] PROGMEM = {
+    0,   3,  11,  24,  40,  59,  81, 104, 128, 152, 175, 197, 216, 232, 245, 253, 256
+};
+
+uint16_t EasingFromTable(const uint16_t *table, uint16_t progress) {
+  if (progress >= OLEDDISPLAYUI_PROGRESS_MAX) return pgm_read_word(table + 16);
+  uint8_t  index = progress >> (OLEDDISPLAYUI_PROGRESS_SHIFT - 4);
+  uint8_t  frac  = progress & ((1 << (OLEDDISPLAYUI_PROGRESS_SHIFT - 4)) - 1);
+  uint16_t from  = pgm_read_word(table + index);
+  uint16_t to    = pgm_read_word(table + index + 1);
+  return from + (((to - from) * frac) >> (OLEDDISPLAYUI_PROGRESS_SHIFT - 4));
+}
+
+uint16_t EasingLinear(uint16_t progress) {
+  return progress;
+}
+
+uint16_t EasingEaseIn(uint16_t progress) {
+  return EasingFromTable(EASING_easeIn, progress);
+}
+
+uint16_t EasingEaseOut(uint16_t progress) {
+  return EasingFromTable(EASING_easeOut, progress);
+}
+
+uint16_t EasingEaseInOut(uint16_t progress) {
+  return EasingFromTable(EASING_easeInOut, progress);
+}
+
 void LoadingDrawDefault(OLEDDisplay *display, LoadingStage* stage, uint8_t progress) {
       display->setTextAlignment(TEXT_ALIGN_CENTER);
       display->setFont(ArialMT_Plain_10);
@@ -47,13 +87,23 @@ OLEDDisplayUi::OLEDDisplayUi(OLEDDisplay *display) {
   activeSymbol = ANIMATION_activeSymbol;
   inactiveSymbol = ANIMATION_inactiveSymbol;
   frameAnimationDirection   = SLIDE_RIGHT;
+  frameAnimationEasing      = EasingLinear;
+  transitionCacheEnabled    = false;
+  transitionCacheValid      = false;
+  transitionCache           = NULL;
+  transitionCacheIndicator  = 0;
   lastTransitionDirection = 1;
   frameCount = 0;
   nextFrameNumber = -1;
   overlayCount = 0;
   indicatorDrawState = 1;
   loadingDrawFunction = LoadingDrawDefault;
-  updateInterval = 33;
+  updateInterval = 33333;
+  nextFrameDue = 0;
+  timelineStarted = false;
+  framePolicy = FRAME_POLICY_FIXED_FPS;
+  tickFraction = 0;
+  resetStats();
   state.lastUpdate = 0;
   state.ticksSinceLastStateSwitch = 0;
   state.frameState = FIXED;
@@ -61,22 +111,35 @@ OLEDDisplayUi::OLEDDisplayUi(OLEDDisplay *display) {
   state.frameTransitionDirection = 1;
   state.isIndicatorDrawn = true;
   state.manualControl = false;
+  state.isStatic = false;
   state.userData = NULL;
+  drawnStatic = false;
+  invalidated = false;
   shouldDrawIndicators = true;
   autoTransition = true;
   setTimePerFrame(5000);
   setTimePerTransition(500);
 }
 
+OLEDDisplayUi::~OLEDDisplayUi() {
+  this->disableTransitionCache();
+}
+
 void OLEDDisplayUi::init() {
   this->display->init();
 }
 
 void OLEDDisplayUi::setTargetFPS(uint8_t fps){
-  this->updateInterval = ((float) 1.0 / (float) fps) * 1000;
+  if (fps == 0) return;
+  this->updateInterval = 1000000UL / fps;
 
-  this->ticksPerFrame = timePerFrame / updateInterval;
-  this->ticksPerTransition = timePerTransition / updateInterval;
+  this->ticksPerFrame = (uint32_t) timePerFrame * 1000 / updateInterval;
+  this->ticksPerTransition = (uint32_t) timePerTransition * 1000 / updateInterval;
+}
+
+void OLEDDisplayUi::setFramePolicy(FramePolicy policy) {
+  this->framePolicy = policy;
+  this->tickFraction = 0;
 }
 
 // -/------ Automatic controll ------\-
@@ -97,11 +160,11 @@ void OLEDDisplayUi::setAutoTransitionBackwards(){
 }
 void OLEDDisplayUi::setTimePerFrame(uint16_t time){
   this->timePerFrame = time;
-  this->ticksPerFrame = timePerFrame / updateInterval;
+  this->ticksPerFrame = (uint32_t) timePerFrame * 1000 / updateInterval;
 }
 void OLEDDisplayUi::setTimePerTransition(uint16_t time){
   this->timePerTransition = time;
-  this->ticksPerTransition = timePerTransition / updateInterval;
+  this->ticksPerTransition = (uint32_t) timePerTransition * 1000 / updateInterval;
 }
 
 // -/------ Customize indicator position and style -------\-
@@ -115,10 +178,12 @@ void OLEDDisplayUi::disableIndicator(){
 
 void OLEDDisplayUi::enableAllIndicators(){
   this->shouldDrawIndicators = true;
+  this->invalidate();
 }
 
 void OLEDDisplayUi::disableAllIndicators(){
   this->shouldDrawIndicators = false;
+  this->invalidate();
 }
 
 void OLEDDisplayUi::setIndicatorPosition(IndicatorPosition pos) {
@@ -139,6 +204,21 @@ void OLEDDisplayUi::setInactiveSymbol(const uint8_t* symbol) {
 void OLEDDisplayUi::setFrameAnimation(AnimationDirection dir) {
   this->frameAnimationDirection = dir;
 }
+void OLEDDisplayUi::enableTransitionCache() {
+  this->transitionCacheEnabled = true;
+  this->transitionCacheValid = false;
+}
+void OLEDDisplayUi::disableTransitionCache() {
+  this->transitionCacheEnabled = false;
+  this->transitionCacheValid = false;
+  if (this->transitionCache) {
+    free(this->transitionCache);
+    this->transitionCache = NULL;
+  }
+}
+void OLEDDisplayUi::setFrameAnimationEasing(EasingFunction easing) {
+  this->frameAnimationEasing = easing ? easing : EasingLinear;
+}
 void OLEDDisplayUi::setFrames(FrameCallback* frameFunctions, uint8_t frameCount) {
   this->frameFunctions = frameFunctions;
   this->frameCount     = frameCount;
@@ -149,6 +229,7 @@ void OLEDDisplayUi::setFrames(FrameCallback* frameFunctions, uint8_t frameCount)
 void OLEDDisplayUi::setOverlays(OverlayCallback* overlayFunctions, uint8_t overlayCount){
   this->overlayFunctions = overlayFunctions;
   this->overlayCount     = overlayCount;
+  this->invalidate();
 }
 
 // -/----- Loading Process -----\-
@@ -206,6 +287,7 @@ void OLEDDisplayUi::switchToFrame(uint8_t frame) {
   this->state.frameState = FIXED;
   this->state.currentFrame = frame;
   this->state.isIndicatorDrawn = true;
+  this->invalidate();
 }
 
 void OLEDDisplayUi::transitionToFrame(uint8_t frame) {
@@ -213,6 +295,7 @@ void OLEDDisplayUi::transitionToFrame(uint8_t frame) {
   this->state.ticksSinceLastStateSwitch = 0;
   if (frame == this->state.currentFrame) return;
   this->nextFrameNumber = frame;
+  this->transitionCacheValid = false;
   this->lastTransitionDirection = this->state.frameTransitionDirection;
   this->state.manualControl = true;
   this->state.frameState = IN_TRANSITION;
@@ -220,36 +303,101 @@ void OLEDDisplayUi::transitionToFrame(uint8_t frame) {
 }
 
 
+void OLEDDisplayUi::invalidate() {
+  this->invalidated = true;
+}
+
 // -/----- State information -----\-
 OLEDDisplayUiState* OLEDDisplayUi::getUiState(){
   return &this->state;
 }
 
+const OLEDDisplayUiStats* OLEDDisplayUi::getStats(){
+  this->stats.fps = 0;
+  if (this->stats.framePeriod > 0) {
+    uint32_t fps = 100000000UL / this->stats.framePeriod;
+    this->stats.fps = fps > UINT16_MAX ? UINT16_MAX : fps;
+  }
+
+  // Sort a copy of the samples to pick the percentiles
+  uint16_t sorted[OLEDDISPLAYUI_JITTER_SAMPLES];
+  uint8_t count = this->jitterSampleCount;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t value = this->jitterSamples[i];
+    uint8_t j = i;
+    for (; j > 0 && sorted[j - 1] > value; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = value;
+  }
+  if (count > 0) {
+    this->stats.jitterP50 = sorted[(count - 1) * 50 / 100];
+    this->stats.jitterP90 = sorted[(count - 1) * 90 / 100];
+    this->stats.jitterP99 = sorted[(count - 1) * 99 / 100];
+  }
+  return &this->stats;
+}
+
+void OLEDDisplayUi::resetStats(){
+  memset(&this->stats, 0, sizeof(this->stats));
+  this->lastFrameStart = 0;
+  this->jitterSampleCount = 0;
+  this->jitterSampleIndex = 0;
+}
+
+void OLEDDisplayUi::recordJitter(uint32_t lateness) {
+  if (lateness > this->stats.maxJitter) this->stats.maxJitter = lateness;
+  this->jitterSamples[this->jitterSampleIndex] = lateness > UINT16_MAX ? UINT16_MAX : lateness;
+  this->jitterSampleIndex = (this->jitterSampleIndex + 1) % OLEDDISPLAYUI_JITTER_SAMPLES;
+  if (this->jitterSampleCount < OLEDDISPLAYUI_JITTER_SAMPLES) this->jitterSampleCount++;
+}
+
 int16_t OLEDDisplayUi::update(){
-#ifdef ARDUINO
-  unsigned long frameStart = millis();
-#elif __MBED__
-	Timer t;
-	t.start();
-	unsigned long frameStart = t.read_ms();
-#else
-#error "Unkown operating system"
-#endif
-  int32_t timeBudget = this->updateInterval - (frameStart - this->state.lastUpdate);
-  if ( timeBudget <= 0) {
+  uint32_t frameStart = micros();
+  bool firstFrame = !this->timelineStarted;
+  if (firstFrame) {
+    // First frame after a reset, the schedule starts now
+    this->nextFrameDue = frameStart;
+    this->timelineStarted = true;
+  }
+
+  int32_t timeBudget = (int32_t) (this->nextFrameDue - frameStart);
+  if (timeBudget <= 0) {
+    uint32_t lateness = -timeBudget;
+    uint32_t missedTicks = lateness / this->updateInterval;
+
     // Implement frame skipping to ensure time budget is kept
-    if (this->autoTransition && this->state.lastUpdate != 0) this->state.ticksSinceLastStateSwitch += ceil((double)-timeBudget / (double)this->updateInterval);
+    if (missedTicks > 0 && this->autoTransition) {
+      this->state.ticksSinceLastStateSwitch += missedTicks;
+      this->stats.skippedTicks += missedTicks;
+    }
+    if (!firstFrame) {
+      this->recordJitter(lateness - missedTicks * this->updateInterval);
+    }
 
-    this->state.lastUpdate = frameStart;
+    // Advance along the ideal timeline rather than from frameStart,
+    // so the lateness of this frame doesn't add up over time
+    this->nextFrameDue += (missedTicks + 1) * this->updateInterval;
+    this->tickFraction = 0;
+
+    this->state.lastUpdate = millis();
     this->tick();
+  } else if (this->framePolicy == FRAME_POLICY_MAX_FPS && this->needsRedraw()) {
+    // Draw an intermediate frame between two ticks of the timeline
+    this->tickFraction = ((this->updateInterval - timeBudget) << OLEDDISPLAYUI_PROGRESS_SHIFT) / this->updateInterval;
+    this->drawUi();
+  }
+
+  if (!this->needsRedraw()) {
+    // Nothing changes before the next automatic transition
+    if (!this->autoTransition) return INT16_MAX;
+    uint32_t ticksLeft = this->ticksPerFrame > this->state.ticksSinceLastStateSwitch ?
+      this->ticksPerFrame - this->state.ticksSinceLastStateSwitch : 1;
+    int32_t sleepTime = ((int32_t) (this->nextFrameDue - micros()) + (int32_t) ((ticksLeft - 1) * this->updateInterval)) / 1000;
+    return sleepTime > INT16_MAX ? INT16_MAX : sleepTime;
   }
-#ifdef ARDUINO
-  return this->updateInterval - (millis() - frameStart);
-#elif __MBED__
-  return this->updateInterval - (t.read_ms() - frameStart);
-#else
-#error "Unkown operating system"
-#endif
+  if (this->framePolicy == FRAME_POLICY_MAX_FPS) return 0;
+  return ((int32_t) (this->nextFrameDue - micros())) / 1000;
 }
 
 
@@ -280,54 +428,86 @@ void OLEDDisplayUi::tick() {
       break;
   }
 
+  if (this->needsRedraw()) {
+    this->drawUi();
+  }
+}
+
+bool OLEDDisplayUi::needsRedraw() {
+  return !this->drawnStatic || this->invalidated || this->state.frameState != FIXED;
+}
+
+void OLEDDisplayUi::drawUi() {
+  uint32_t drawStart = micros();
+  // Cleared first, an invalidate() from a frame or overlay callback asks for the next frame
+  this->invalidated = false;
   this->display->clear();
   this->drawFrame();
   if (shouldDrawIndicators) {
     this->drawIndicator();
   }
   this->drawOverlays();
+
+  uint32_t flushStart = micros();
   this->display->display();
+  uint32_t flushEnd = micros();
+
+  this->stats.drawTime     = flushStart - drawStart;
+  if (this->stats.drawTime > this->stats.maxDrawTime) this->stats.maxDrawTime = this->stats.drawTime;
+  this->stats.flushTime    = flushEnd - flushStart;
+  if (this->stats.flushTime > this->stats.maxFlushTime) this->stats.maxFlushTime = this->stats.flushTime;
+
+  if (this->stats.frames > 0) {
+    // Moving average over roughly the last 8 frames
+    uint32_t period = drawStart - this->lastFrameStart;
+    this->stats.framePeriod = this->stats.framePeriod - (this->stats.framePeriod >> 3) + (period >> 3);
+    if (this->stats.frames == 1) this->stats.framePeriod = period;
+  }
+  this->lastFrameStart = drawStart;
+  this->stats.frames++;
 }
 
 void OLEDDisplayUi::resetState() {
   this->state.lastUpdate = 0;
+  this->timelineStarted = false;
   this->state.ticksSinceLastStateSwitch = 0;
   this->state.frameState = FIXED;
   this->state.currentFrame = 0;
   this->state.isIndicatorDrawn = true;
+  this->drawnStatic = false;
 }
 
 void OLEDDisplayUi::drawFrame(){
   switch (this->state.frameState){
      case IN_TRANSITION: {
-       float progress = 0.f;
-       if (this->ticksPerTransition > 0u) {
-         progress = (float) this->state.ticksSinceLastStateSwitch / (float) this->ticksPerTransition;
-       }
+       this->drawnStatic = false;
+       uint16_t progress = this->getTransitionProgress();
+       int16_t width  = (this->display->width()  * progress) >> OLEDDISPLAYUI_PROGRESS_SHIFT;
+       int16_t height = (this->display->height() * progress) >> OLEDDISPLAYUI_PROGRESS_SHIFT;
        int16_t x = 0, y = 0, x1 = 0, y1 = 0;
        switch(this->frameAnimationDirection){
         case SLIDE_LEFT:
-          x = -this->display->width() * progress;
+          x = -width;
           y = 0;
           x1 = x + this->display->width();
           y1 = 0;
           break;
         case SLIDE_RIGHT:
-          x = this->display->width() * progress;
+          x = width;
           y = 0;
           x1 = x - this->display->width();
           y1 = 0;
           break;
         case SLIDE_UP:
           x = 0;
-          y = -this->display->height() * progress;
+          y = -height;
           x1 = 0;
           y1 = y + this->display->height();
           break;
         case SLIDE_DOWN:
         default:
           x = 0;
-          y = this->display->height() * progress;
+          y = height;
           x1 = 0;
           y1 = y - this->display->height();
           break;
@@ -339,14 +519,26 @@ void OLEDDisplayUi::drawFrame(){
 
        bool drawnCurrentFrame;
 
-
-       // Probe each frameFunction for the indicator drawn state
-       this->enableIndicator();
-       (this->frameFunctions[this->state.currentFrame])(this->display, &this->state, x, y);
-       drawnCurrentFrame = this->state.isIndicatorDrawn;
-
-       this->enableIndicator();
-       (this->frameFunctions[this->getNextFrameNumber()])(this->display, &this->state, x1, y1);
+       if (this->transitionCacheEnabled && this->prepareTransitionCache()) {
+         // Both frames were rendered once at the start of the transition,
+         // only shift their snapshots into place
+         uint16_t bufferSize = this->display->width() * this->display->height() / 8;
+         OLEDDISPLAY_COLOR color = this->display->getColor();
+         this->display->setColor(WHITE);
+         this->display->drawPageBuffer(x, y, this->display->width(), this->display->height(), this->transitionCache);
+         this->display->drawPageBuffer(x1, y1, this->display->width(), this->display->height(), this->transitionCache + bufferSize);
+         this->display->setColor(color);
+         drawnCurrentFrame = this->transitionCacheIndicator & 1;
+         this->state.isIndicatorDrawn = this->transitionCacheIndicator & 2;
+       } else {
+         // Probe each frameFunction for the indicator drawn state
+         this->enableIndicator();
+         (this->frameFunctions[this->state.currentFrame])(this->display, &this->state, x, y);
+         drawnCurrentFrame = this->state.isIndicatorDrawn;
+
+         this->enableIndicator();
+         (this->frameFunctions[this->getNextFrameNumber()])(this->display, &this->state, x1, y1);
+       }
 
        // Build up the indicatorDrawState
        if (drawnCurrentFrame && !this->state.isIndicatorDrawn) {
@@ -370,8 +562,11 @@ void OLEDDisplayUi::drawFrame(){
       // Always assume that the indicator is drawn!
       // And set indicatorDrawState to "not known yet"
       this->indicatorDrawState = 0;
+      this->transitionCacheValid = false;
       this->enableIndicator();
+      this->state.isStatic = false;
       (this->frameFunctions[this->state.currentFrame])(this->display, &this->state, 0, 0);
+      this->drawnStatic = this->state.isStatic;
       break;
   }
 }
@@ -386,7 +581,7 @@ void OLEDDisplayUi::drawIndicator() {
     }
 
     uint8_t posOfHighlightFrame = 0;
-    float indicatorFadeProgress = 0;
+    uint16_t indicatorFadeProgress = 0;
 
     // if the indicator needs to be slided in we want to
     // highlight the next frame in the transition
@@ -407,11 +602,11 @@ void OLEDDisplayUi::drawIndicator() {
     switch (this->indicatorDrawState) {
       case 1: // Indicator was not drawn in this frame but will be in next
         // Slide IN
-        indicatorFadeProgress = 1 - ((float) this->state.ticksSinceLastStateSwitch / (float) this->ticksPerTransition);
+        indicatorFadeProgress = OLEDDISPLAYUI_PROGRESS_MAX - this->getTransitionProgress();
         break;
       case 2: // Indicator was drawn in this frame but not in next
         // Slide OUT
-        indicatorFadeProgress = ((float) this->state.ticksSinceLastStateSwitch / (float) this->ticksPerTransition);
+        indicatorFadeProgress = this->getTransitionProgress();
         break;
     }
 
@@ -421,6 +616,9 @@ void OLEDDisplayUi::drawIndicator() {
       indicatorSpacing = 6;
     }
 
+    // Offset of the sliding indicator in pixels
+    int16_t indicatorFade = (8 * indicatorFadeProgress) >> OLEDDISPLAYUI_PROGRESS_SHIFT;
+
     uint16_t frameStartPos = (indicatorSpacing * frameCount / 2);
     const uint8_t *image;
 
@@ -431,20 +629,20 @@ void OLEDDisplayUi::drawIndicator() {
 
       switch (this->indicatorPosition){
         case TOP:
-          y = 0 - (8 * indicatorFadeProgress);
+          y = 0 - indicatorFade;
           x = (this->display->width() / 2) - frameStartPos + 12 * i;
           break;
         case BOTTOM:
-          y = (this->display->height() - 8) + (8 * indicatorFadeProgress);
+          y = (this->display->height() - 8) + indicatorFade;
           x = (this->display->width() / 2) - frameStartPos + 12 * i;
           break;
         case RIGHT:
-          x = (this->display->width() - 8) + (8 * indicatorFadeProgress);
+          x = (this->display->width() - 8) + indicatorFade;
           y = (this->display->height() / 2) - frameStartPos + 2 + 12 * i;
           break;
         case LEFT:
         default:
-          x = 0 - (8 * indicatorFadeProgress);
+          x = 0 - indicatorFade;
           y = (this->display->height() / 2) - frameStartPos + 2 + indicatorSpacing * i;
           break;
       }
@@ -461,10 +659,50 @@ void OLEDDisplayUi::drawIndicator() {
 
 void OLEDDisplayUi::drawOverlays() {
  for (uint8_t i=0;i<this->overlayCount;i++){
+    this->state.isStatic = false;
     (this->overlayFunctions[i])(this->display, &this->state);
+    this->drawnStatic = this->drawnStatic && this->state.isStatic;
  }
 }
 
+bool OLEDDisplayUi::prepareTransitionCache() {
+  if (this->transitionCacheValid) return true;
+
+  uint16_t bufferSize = this->display->width() * this->display->height() / 8;
+  if (this->transitionCache == NULL) {
+    this->transitionCache = (uint8_t*) malloc(2 * bufferSize);
+    if (!this->transitionCache) {
+      DEBUG_OLEDDISPLAYUI("[OLEDDISPLAYUI][prepareTransitionCache] Not enough memory for the transition cache\n");
+      return false;
+    }
+  }
+
+  // Render the current and the next frame once, unshifted
+  this->transitionCacheIndicator = 0;
+  this->display->clear();
+  this->enableIndicator();
+  (this->frameFunctions[this->state.currentFrame])(this->display, &this->state, 0, 0);
+  if (this->state.isIndicatorDrawn) this->transitionCacheIndicator |= 1;
+  memcpy(this->transitionCache, this->display->buffer, bufferSize);
+
+  this->display->clear();
+  this->enableIndicator();
+  (this->frameFunctions[this->getNextFrameNumber()])(this->display, &this->state, 0, 0);
+  if (this->state.isIndicatorDrawn) this->transitionCacheIndicator |= 2;
+  memcpy(this->transitionCache + bufferSize, this->display->buffer, bufferSize);
+
+  this->display->clear();
+  this->transitionCacheValid = true;
+  return true;
+}
+
+uint16_t OLEDDisplayUi::getTransitionProgress() {
+  if (this->ticksPerTransition == 0) return 0;
+  uint32_t progress = (((uint32_t) this->state.ticksSinceLastStateSwitch << OLEDDISPLAYUI_PROGRESS_SHIFT) + this->tickFraction) / this->ticksPerTransition;
+  if (progress > OLEDDISPLAYUI_PROGRESS_MAX) progress = OLEDDISPLAYUI_PROGRESS_MAX;
+  return this->frameAnimationEasing(progress);
+}
+
 uint8_t OLEDDisplayUi::getNextFrameNumber(){
   if (this->nextFrameNumber != -1) return this->nextFrameNumber;
   return (this->state.currentFrame + this->frameCount + this->state.frameTransitionDirection) % this->frameCount;
@@ -36,6 +36,8 @@
 #include <Arduino.h>
 #elif __MBED__
 #include <mbed.h>
+#elif __linux__
+#include <stdint.h>
 #else
 #error "Unkown operating system"
 #endif
@@ -55,6 +57,11 @@ enum AnimationDirection {
   SLIDE_RIGHT
 };
 
+// Transition progress is passed around in Q8 fixed point,
+// 0 is the start and OLEDDISPLAYUI_PROGRESS_MAX the end of a transition
+#define OLEDDISPLAYUI_PROGRESS_SHIFT 8
+#define OLEDDISPLAYUI_PROGRESS_MAX   (1 << OLEDDISPLAYUI_PROGRESS_SHIFT)
+
 enum IndicatorPosition {
   TOP,
   RIGHT,
@@ -72,6 +79,18 @@ enum FrameState {
   FIXED
 };
 
+enum FramePolicy {
+  // Draw one frame per target FPS interval, update() tells how long to wait
+  FRAME_POLICY_FIXED_FPS,
+  // Draw on every call of update(), transitions still advance with the target FPS timeline
+  FRAME_POLICY_MAX_FPS
+};
+
+// Number of frames the jitter percentiles are computed from
+#ifndef OLEDDISPLAYUI_JITTER_SAMPLES
+#define OLEDDISPLAYUI_JITTER_SAMPLES 32
+#endif
+
 
 const uint8_t ANIMATION_activeSymbol[] PROGMEM = {
   0x00, 0x18, 0x3c, 0x7e, 0x7e, 0x3c, 0x18, 0x00
@@ -97,10 +116,30 @@ struct OLEDDisplayUiState {
 
   bool          manualControl;
 
+  // Set by a frame or overlay callback to declare that what it draws doesn't
+  // change until OLEDDisplayUi::invalidate() is called. Reset before each callback.
+  bool          isStatic;
+
   // Custom data that can be used by the user
   void*         userData;
 };
 
+// Frame pacing statistics, all times in microseconds
+struct OLEDDisplayUiStats {
+  uint32_t      frames;          // frames drawn since the last reset
+  uint32_t      skippedTicks;    // ticks dropped to keep up with the timeline
+  uint16_t      fps;             // measured frames per second * 100
+  uint32_t      framePeriod;     // average time between two frames
+  uint32_t      drawTime;        // time spent in frame, indicator and overlay drawing
+  uint32_t      maxDrawTime;
+  uint32_t      flushTime;       // time spent in display()
+  uint32_t      maxFlushTime;
+  uint32_t      jitterP50;       // lateness of frame starts against the schedule
+  uint32_t      jitterP90;
+  uint32_t      jitterP99;
+  uint32_t      maxJitter;
+};
+
 struct LoadingStage {
   const char* process;
   void (*callback)();
@@ -110,6 +149,20 @@ typedef void (*FrameCallback)(OLEDDisplay *display,  OLEDDisplayUiState* state,
 typedef void (*OverlayCallback)(OLEDDisplay *display,  OLEDDisplayUiState* state);
 typedef void (*LoadingDrawFunction)(OLEDDisplay *display, LoadingStage* stage, uint8_t progress);
 
+// Maps the linear transition progress (0..OLEDDISPLAYUI_PROGRESS_MAX)
+// to the eased progress in the same range
+typedef uint16_t (*EasingFunction)(uint16_t progress);
+
+// Evaluates an easing curve given as 17 PROGMEM points (0..OLEDDISPLAYUI_PROGRESS_MAX),
+// sampled at equal steps, interpolating linearly in between
+uint16_t EasingFromTable(const uint16_t *table, uint16_t progress);
+
+// Built-in easing curves
+uint16_t EasingLinear(uint16_t progress);
+uint16_t EasingEaseIn(uint16_t progress);
+uint16_t EasingEaseOut(uint16_t progress);
+uint16_t EasingEaseInOut(uint16_t progress);
+
 class OLEDDisplayUi {
   private:
     OLEDDisplay             *display;
@@ -125,6 +178,14 @@ class OLEDDisplayUi {
 
     // Values for the Frames
     AnimationDirection  frameAnimationDirection;
+    EasingFunction      frameAnimationEasing;
+
+    // Snapshots of the current and the next frame taken at the start of a transition
+    bool                transitionCacheEnabled;
+    bool                transitionCacheValid;
+    uint8_t*            transitionCache;
+    // Bit 0: indicator drawn by the current frame, bit 1: by the next frame
+    uint8_t             transitionCacheIndicator;
 
     int8_t              lastTransitionDirection;
 
@@ -156,22 +217,45 @@ class OLEDDisplayUi {
     // UI State
     OLEDDisplayUiState      state;
 
-    // Bookeeping for update
-    uint16_t            updateInterval            = 33;
+    // Bookeeping for update, times in microseconds
+    uint32_t            updateInterval            = 33333;
+    uint32_t            nextFrameDue;
+    bool                timelineStarted;
+    FramePolicy         framePolicy;
+
+    // Q8 fraction of the current tick that has elapsed, only used with FRAME_POLICY_MAX_FPS
+    uint16_t            tickFraction;
+
+    // Set when the last drawn FIXED frame and all overlays declared themselves static
+    bool                drawnStatic;
+    bool                invalidated;
+
+    // Frame pacing statistics
+    OLEDDisplayUiStats  stats;
+    uint32_t            lastFrameStart;
+    uint16_t            jitterSamples[OLEDDISPLAYUI_JITTER_SAMPLES];
+    uint8_t             jitterSampleCount;
+    uint8_t             jitterSampleIndex;
 
     uint16_t            timePerFrame;
     uint16_t            timePerTransition;
 
     uint8_t             getNextFrameNumber();
+    uint16_t            getTransitionProgress();
+    bool                prepareTransitionCache();
     void                drawIndicator();
     void                drawFrame();
     void                drawOverlays();
     void                tick();
+    void                drawUi();
+    bool                needsRedraw();
+    void                recordJitter(uint32_t lateness);
     void                resetState();
 
   public:
 
     OLEDDisplayUi(OLEDDisplay *display);
+    ~OLEDDisplayUi();
 
     /**
      * Initialise the display
@@ -183,6 +267,12 @@ class OLEDDisplayUi {
      */
     void setTargetFPS(uint8_t fps);
 
+    /**
+     * Choose between drawing at the target FPS (FRAME_POLICY_FIXED_FPS, default)
+     * or on every call of update() (FRAME_POLICY_MAX_FPS)
+     */
+    void setFramePolicy(FramePolicy policy);
+
     // Automatic Control
     /**
      * Enable automatic transition to next frame after the some time can be configured with `setTimePerFrame` and `setTimePerTransition`.
@@ -265,6 +355,24 @@ class OLEDDisplayUi {
      */
     void setFrameAnimation(AnimationDirection dir);
 
+    /**
+     * Configure the easing curve of the transition, e.g. EasingEaseInOut.
+     * Defaults to EasingLinear.
+     */
+    void setFrameAnimationEasing(EasingFunction easing);
+
+    /**
+     * Render the current and the next frame only once at the start of a transition
+     * and slide their snapshots instead of calling the frame functions on every tick.
+     * Costs two extra display buffers of RAM, frames don't update while sliding.
+     */
+    void enableTransitionCache();
+
+    /**
+     * Call the frame functions on every tick of a transition (default) and free the snapshots.
+     */
+    void disableTransitionCache();
+
     /**
      * Add frame drawing functions
      */
@@ -307,9 +415,28 @@ class OLEDDisplayUi {
      */
     void transitionToFrame(uint8_t frame);
 
+    /**
+     * Redraw on the next update(). Needed when the content of a frame or
+     * overlay that declared itself static (state->isStatic) has changed.
+     */
+    void invalidate();
+
     // State Info
     OLEDDisplayUiState* getUiState();
 
+    /**
+     * Measured frame rate, draw and flush times and scheduling jitter
+     */
+    const OLEDDisplayUiStats* getStats();
+    void resetStats();
+
+    /**
+     * This needs to be called in the main loop. Returns the time (in ms)
+     * until the next frame is due, negative if the frame budget was exceeded.
+     * While a static frame is shown this is the time until the next automatic
+     * transition (at most INT16_MAX), the caller may sleep that long unless it
+     * calls invalidate().
+     */
     int16_t update();
 };
 #endif
@@ -0,0 +1,527 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#include "OLEDDisplayWidgets.h"
+
+// sin(x) for x = 0..90 degrees in 16 steps, Q8 fixed point
+const uint16_t WIDGET_sine[] PROGMEM = {
+    0,  25,  50,  74,  98, 121, 142, 162, 181, 198, 213, 226, 237, 245, 251, 255, 256
+};
+
+// sin(degrees) for 0..90 degrees in Q8 fixed point
+static int16_t widgetSine(uint8_t degrees) {
+  uint16_t position = degrees * 16;
+  uint8_t  index    = position / 90;
+  uint8_t  frac     = position % 90;
+  if (index >= 16) return pgm_read_word(WIDGET_sine + 16);
+  int16_t from = pgm_read_word(WIDGET_sine + index);
+  int16_t to   = pgm_read_word(WIDGET_sine + index + 1);
+  return from + (to - from) * frac / 90;
+}
+
+// -/----- OLEDWidget -----\-
+
+OLEDWidget::OLEDWidget(int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  this->x = this->oldX = x;
+  this->y = this->oldY = y;
+  this->width = this->oldWidth = width;
+  this->height = this->oldHeight = height;
+  this->dirty = true;
+  this->firstChild = NULL;
+  this->nextSibling = NULL;
+  this->parent = NULL;
+}
+
+void OLEDWidget::add(OLEDWidget *child) {
+  child->parent = this;
+  child->nextSibling = NULL;
+  child->dirty = true;
+  if (this->firstChild == NULL) {
+    this->firstChild = child;
+    return;
+  }
+  OLEDWidget *last = this->firstChild;
+  while (last->nextSibling != NULL) {
+    last = last->nextSibling;
+  }
+  last->nextSibling = child;
+}
+
+void OLEDWidget::setBounds(int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  if (x == this->x && y == this->y && width == this->width && height == this->height) return;
+  this->x = x;
+  this->y = y;
+  this->width = width;
+  this->height = height;
+  // The parent paints over the old area, children must stay within their parent
+  if (this->parent) this->parent->invalidate();
+  this->invalidate();
+}
+
+void OLEDWidget::invalidate() {
+  this->dirty = true;
+}
+
+bool OLEDWidget::update(OLEDDisplay *display) {
+  if (!paintTree(display)) return false;
+  display->display();
+  return true;
+}
+
+bool OLEDWidget::paintTree(OLEDDisplay *display) {
+  OLEDDISPLAY_COLOR color = display->getColor();
+  bool painted = paintSubtree(display, false);
+  display->setColor(color);
+  return painted;
+}
+
+bool OLEDWidget::paintSubtree(OLEDDisplay *display, bool force) {
+  bool painted = false;
+  if (force || this->dirty) {
+    display->setColor(BLACK);
+    if (this->parent == NULL && (this->oldX != this->x || this->oldY != this->y ||
+        this->oldWidth != this->width || this->oldHeight != this->height)) {
+      display->fillRect(this->oldX, this->oldY, this->oldWidth, this->oldHeight);
+    }
+    display->fillRect(this->x, this->y, this->width, this->height);
+    display->setColor(WHITE);
+    paint(display);
+
+    this->oldX = this->x;
+    this->oldY = this->y;
+    this->oldWidth = this->width;
+    this->oldHeight = this->height;
+    this->dirty = false;
+    // Everything on top of this widget has been cleared as well
+    force = true;
+    painted = true;
+  } else {
+    display->setColor(WHITE);
+    painted = paintChanges(display);
+  }
+  for (OLEDWidget *child = this->firstChild; child != NULL; child = child->nextSibling) {
+    painted |= child->paintSubtree(display, force);
+  }
+  return painted;
+}
+
+// -/----- OLEDLabelWidget -----\-
+
+OLEDLabelWidget::OLEDLabelWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, const char *text,
+                                 const uint16_t *font, OLEDDISPLAY_TEXT_ALIGNMENT alignment)
+  : OLEDWidget(x, y, width, height) {
+  this->text[0] = 0;
+  this->font = font;
+  this->alignment = alignment;
+  setText(text);
+}
+
+void OLEDLabelWidget::setText(const char *text) {
+  if (text == NULL) text = "";
+  if (strncmp(this->text, text, OLEDWIDGET_TEXT_LENGTH - 1) == 0) return;
+  strncpy(this->text, text, OLEDWIDGET_TEXT_LENGTH - 1);
+  this->text[OLEDWIDGET_TEXT_LENGTH - 1] = 0;
+  invalidate();
+}
+
+void OLEDLabelWidget::setFont(const uint16_t *font) {
+  if (this->font == font) return;
+  this->font = font;
+  invalidate();
+}
+
+void OLEDLabelWidget::setAlignment(OLEDDISPLAY_TEXT_ALIGNMENT alignment) {
+  if (this->alignment == alignment) return;
+  this->alignment = alignment;
+  invalidate();
+}
+
+void OLEDLabelWidget::paint(OLEDDisplay *display) {
+  paintText(display, this->text);
+}
+
+void OLEDLabelWidget::paintText(OLEDDisplay *display, const char *text) {
+  const uint16_t *font = display->getFont();
+  OLEDDISPLAY_TEXT_ALIGNMENT alignment = display->getTextAlignment();
+  if (this->font) display->setFont(this->font);
+  display->setTextAlignment(this->alignment);
+  int16_t textX = this->x;
+  int16_t textY = this->y;
+  switch (this->alignment) {
+    case TEXT_ALIGN_CENTER_BOTH:
+      textY += this->height / 2;
+    // Fallthrough
+    case TEXT_ALIGN_CENTER:
+      textX += this->width / 2;
+      break;
+    case TEXT_ALIGN_RIGHT:
+      textX += this->width;
+      break;
+    case TEXT_ALIGN_LEFT:
+      break;
+  }
+  display->drawString(textX, textY, text);
+  display->setFont(font);
+  display->setTextAlignment(alignment);
+}
+
+// -/----- OLEDValueWidget -----\-
+
+OLEDValueWidget::OLEDValueWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t decimals,
+                                 const char *unit, const uint16_t *font, OLEDDISPLAY_TEXT_ALIGNMENT alignment)
+  : OLEDLabelWidget(x, y, width, height, "", font, alignment) {
+  this->value = 0;
+  this->decimals = decimals > 9 ? 9 : decimals;
+  this->unit = unit;
+}
+
+void OLEDValueWidget::setValue(int32_t value) {
+  if (this->value == value && !this->dirty) return;
+  this->value = value;
+  invalidate();
+}
+
+void OLEDValueWidget::paint(OLEDDisplay *display) {
+  char text[OLEDWIDGET_TEXT_LENGTH];
+  const char *unit = this->unit ? this->unit : "";
+  uint32_t magnitude = this->value < 0 ? -(uint32_t) this->value : this->value;
+
+  // Digits from the last one on, at least one before the point: 10 at most
+  char    digits[10];
+  uint8_t count = 0;
+  do {
+    digits[count++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude || count <= this->decimals);
+
+  uint8_t length = 0;
+  if (this->value < 0) text[length++] = '-';
+  while (count > 0) {
+    if (count == this->decimals) text[length++] = '.';
+    text[length++] = digits[--count];
+  }
+
+  // The unit gets what is left of the text
+  int unitLength = snprintf(text + length, sizeof(text) - length, "%s", unit);
+  if (unitLength < 0 || unitLength >= (int) (sizeof(text) - length)) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDValueWidget] Unit too long, it is cut\n");
+  }
+  paintText(display, text);
+}
+
+// -/----- OLEDIconWidget -----\-
+
+OLEDIconWidget::OLEDIconWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *xbm)
+  : OLEDWidget(x, y, width, height) {
+  this->xbm = xbm;
+}
+
+void OLEDIconWidget::setIcon(const uint8_t *xbm) {
+  if (this->xbm == xbm) return;
+  this->xbm = xbm;
+  invalidate();
+}
+
+void OLEDIconWidget::paint(OLEDDisplay *display) {
+  if (this->xbm) display->drawXbm(this->x, this->y, this->width, this->height, this->xbm);
+}
+
+// -/----- OLEDBarWidget -----\-
+
+OLEDBarWidget::OLEDBarWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t progress)
+  : OLEDWidget(x, y, width, height) {
+  this->progress = progress > 100 ? 100 : progress;
+}
+
+void OLEDBarWidget::setProgress(uint8_t progress) {
+  if (progress > 100) progress = 100;
+  if (this->progress == progress) return;
+  this->progress = progress;
+  invalidate();
+}
+
+void OLEDBarWidget::paint(OLEDDisplay *display) {
+  display->drawRect(this->x, this->y, this->width, this->height);
+  if (this->width > 4 && this->height > 4) {
+    display->fillRect(this->x + 2, this->y + 2, (this->width - 4) * this->progress / 100, this->height - 4);
+  }
+}
+
+// -/----- OLEDGaugeWidget -----\-
+
+OLEDGaugeWidget::OLEDGaugeWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t progress)
+  : OLEDBarWidget(x, y, width, height, progress) {
+}
+
+void OLEDGaugeWidget::paint(OLEDDisplay *display) {
+  int16_t radius = this->width / 2 - 1;
+  if (radius > (int16_t) this->height - 1) radius = this->height - 1;
+  if (radius < 3) return;
+  int16_t centerX = this->x + this->width / 2;
+  int16_t centerY = this->y + radius;
+
+  display->drawCircleQuads(centerX, centerY, radius, 0x03);
+  display->drawHorizontalLine(centerX - radius, centerY, 2 * radius + 1);
+
+  // The needle goes from 180 degrees (0%) to 0 degrees (100%)
+  uint8_t angle  = 180 - this->progress * 180 / 100;
+  int16_t length = radius - 2;
+  int16_t sine   = widgetSine(angle <= 90 ? angle : 180 - angle);
+  int16_t cosine = angle <= 90 ? widgetSine(90 - angle) : -widgetSine(angle - 90);
+  display->drawLine(centerX, centerY, centerX + ((cosine * length) >> 8), centerY - ((sine * length) >> 8));
+}
+
+// -/----- OLEDChartWidget -----\-
+
+OLEDChartWidget::OLEDChartWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, int16_t minValue, int16_t maxValue)
+  : OLEDWidget(x, y, width, height) {
+  // One sample more than columns so the leftmost column can still be connected to its predecessor
+  this->capacity = width + 1;
+  this->samples = (int16_t*) malloc(sizeof(int16_t) * this->capacity);
+  if (!this->samples) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDChartWidget] Not enough memory to create sample buffer\n");
+    this->capacity = 0;
+  }
+  this->count = 0;
+  this->head = 0;
+  this->pendingSamples = 0;
+  this->minValue = minValue;
+  this->maxValue = maxValue > minValue ? maxValue : minValue + 1;
+}
+
+OLEDChartWidget::~OLEDChartWidget() {
+  if (this->samples) free(this->samples);
+}
+
+void OLEDChartWidget::addSample(int16_t value) {
+  if (this->capacity == 0) return;
+  if (value < this->minValue) value = this->minValue;
+  if (value > this->maxValue) value = this->maxValue;
+  this->samples[this->head] = value;
+  this->head = (this->head + 1) % this->capacity;
+  if (this->count < this->capacity) this->count++;
+  this->pendingSamples++;
+}
+
+void OLEDChartWidget::clearSamples() {
+  this->count = 0;
+  this->head = 0;
+  invalidate();
+}
+
+int16_t OLEDChartWidget::valueToRow(int16_t value) {
+  return this->y + this->height - 1 -
+    (int32_t) (value - this->minValue) * (this->height - 1) / (this->maxValue - this->minValue);
+}
+
+void OLEDChartWidget::drawSample(OLEDDisplay *display, uint16_t age) {
+  uint16_t index   = (this->head + this->capacity - 1 - age) % this->capacity;
+  int16_t  column  = this->x + this->width - 1 - age;
+  int16_t  row     = valueToRow(this->samples[index]);
+  if (age + 1 >= this->count) {
+    display->setPixel(column, row);
+    return;
+  }
+  // Connect to the previous sample with a vertical line
+  int16_t previous = valueToRow(this->samples[(index + this->capacity - 1) % this->capacity]);
+  if (previous > row) {
+    display->drawVerticalLine(column, row, previous - row);
+  } else if (previous < row) {
+    display->drawVerticalLine(column, previous + 1, row - previous);
+  } else {
+    display->setPixel(column, row);
+  }
+}
+
+void OLEDChartWidget::paint(OLEDDisplay *display) {
+  for (uint16_t age = 0; age < this->count && age < this->width; age++) {
+    drawSample(display, age);
+  }
+  this->pendingSamples = 0;
+}
+
+bool OLEDChartWidget::paintChanges(OLEDDisplay *display) {
+  if (this->pendingSamples == 0) return false;
+
+  bool onScreen = this->x >= 0 && this->y >= 0 &&
+    this->x + this->width <= display->width() && this->y + this->height <= display->height();
+  if (this->pendingSamples >= this->width || !onScreen) {
+    // Nothing of the old plot is left, draw it from scratch
+    display->setColor(BLACK);
+    display->fillRect(this->x, this->y, this->width, this->height);
+    display->setColor(WHITE);
+    paint(display);
+    return true;
+  }
+
+  scrollLeft(display, this->pendingSamples);
+  for (uint16_t age = 0; age < this->pendingSamples; age++) {
+    drawSample(display, age);
+  }
+  this->pendingSamples = 0;
+  return true;
+}
+
+void OLEDChartWidget::scrollLeft(OLEDDisplay *display, uint16_t columns) {
+  int16_t lastRow = this->y + this->height - 1;
+  for (int16_t page = this->y >> 3; page <= (lastRow >> 3); page++) {
+    // Rows of this page that belong to the chart
+    uint8_t mask = 0xFF;
+    if (page == (this->y >> 3))   mask &= 0xFF << (this->y & 7);
+    if (page == (lastRow >> 3))   mask &= 0xFF >> (7 - (lastRow & 7));
+
+    uint8_t *row = display->buffer + page * display->width() + this->x;
+    if (mask == 0xFF) {
+      memmove(row, row + columns, this->width - columns);
+      memset(row + this->width - columns, 0, columns);
+    } else {
+      for (uint16_t column = 0; column < this->width; column++) {
+        uint8_t moved = column + columns < this->width ? row[column + columns] : 0;
+        row[column] = (row[column] & ~mask) | (moved & mask);
+      }
+    }
+  }
+}
+
+// -/----- OLEDScrollTextWidget -----\-
+
+OLEDScrollTextWidget::OLEDScrollTextWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, const char *text,
+                                           const uint16_t *font, bool vertical, uint16_t gap)
+  : OLEDWidget(x, y, width, height) {
+  this->text = text;
+  this->font = font;
+  this->vertical = vertical;
+  this->gap = gap;
+  this->position = 0;
+  this->strip = NULL;
+  this->stripWidth = 0;
+  this->stripHeight = 0;
+}
+
+OLEDScrollTextWidget::~OLEDScrollTextWidget() {
+  if (this->strip) free(this->strip);
+}
+
+void OLEDScrollTextWidget::setText(const char *text) {
+  this->text = text;
+  this->position = 0;
+  // Rendered again on the next paint
+  if (this->strip) free(this->strip);
+  this->strip = NULL;
+  this->stripWidth = 0;
+  this->stripHeight = 0;
+  invalidate();
+}
+
+void OLEDScrollTextWidget::setFont(const uint16_t *font) {
+  if (this->font == font) return;
+  this->font = font;
+  setText(this->text);
+}
+
+void OLEDScrollTextWidget::scroll(int16_t pixels) {
+  uint16_t length = getContentLength();
+  if (length == 0 || pixels == 0) return;
+  int32_t position = ((int32_t) this->position + pixels) % length;
+  this->position = position < 0 ? position + length : position;
+  invalidate();
+}
+
+void OLEDScrollTextWidget::setScrollPosition(uint16_t position) {
+  uint16_t length = getContentLength();
+  if (length > 0) position %= length;
+  if (this->position == position) return;
+  this->position = position;
+  invalidate();
+}
+
+void OLEDScrollTextWidget::render(OLEDDisplay *display) {
+  const uint16_t *font = display->getFont();
+  OLEDDISPLAY_TEXT_ALIGNMENT alignment = display->getTextAlignment();
+  if (this->font) display->setFont(this->font);
+  display->setTextAlignment(TEXT_ALIGN_LEFT);
+  renderStrip(display);
+  display->setFont(font);
+  display->setTextAlignment(alignment);
+}
+
+void OLEDScrollTextWidget::renderStrip(OLEDDisplay *display) {
+  OLEDDisplayTextLayout layout;
+  uint32_t width, height;
+  if (this->vertical) {
+    if (!display->layoutText(&layout, this->text, this->width)) return;
+    width  = this->width;
+    height = layout.getHeight() + this->gap;
+  } else {
+    width  = display->getStringWidth(this->text, strlen(this->text), true) + this->gap;
+    height = this->height;
+  }
+  // Drawing into the strip uses int16_t positions
+  uint32_t size = width * ((height + 7) >> 3);
+  if (width > 0x7FFF || height > 0x7FFF || size > 0x7FFF || size == 0) return;
+
+  this->strip = (uint8_t*) calloc(size, 1);
+  if (!this->strip) {
+    DEBUG_OLEDDISPLAY("[OLEDDISPLAY][OLEDScrollTextWidget] Not enough memory to render the text\n");
+    return;
+  }
+  this->stripWidth = width;
+  this->stripHeight = height;
+
+  display->setDrawTarget(this->strip, this->stripWidth, this->stripHeight);
+  if (this->vertical) {
+    display->drawTextLayout(0, 0, &layout);
+  } else {
+    display->drawString(0, 0, this->text);
+  }
+  display->setDrawTarget(NULL);
+  this->position %= this->vertical ? this->stripHeight : this->stripWidth;
+}
+
+void OLEDScrollTextWidget::paint(OLEDDisplay *display) {
+  if (!this->strip && this->text && this->text[0]) render(display);
+  if (!this->strip) return;
+
+  // Copy the window, wrapping around to the start of the strip
+  uint16_t extent = this->vertical ? this->height : this->width;
+  uint16_t length = this->vertical ? this->stripHeight : this->stripWidth;
+  uint16_t source = this->position;
+  for (uint16_t done = 0; done < extent; done += length - source, source = 0) {
+    uint16_t part = extent - done < length - source ? extent - done : length - source;
+    if (this->vertical) {
+      display->drawPageBuffer(this->x, this->y + done, this->width, part, this->strip,
+                              this->stripWidth, this->stripHeight, 0, source);
+    } else {
+      display->drawPageBuffer(this->x + done, this->y, part, this->height, this->strip,
+                              this->stripWidth, this->stripHeight, source, 0);
+    }
+  }
+}
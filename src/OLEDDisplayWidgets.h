@@ -0,0 +1,278 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef OLEDDISPLAYWIDGETS_h
+#define OLEDDISPLAYWIDGETS_h
+
+#include "OLEDDisplay.h"
+
+// Maximum length of the text of a label, including the terminating 0
+#ifndef OLEDWIDGET_TEXT_LENGTH
+#define OLEDWIDGET_TEXT_LENGTH 24
+#endif
+
+/**
+ * Base class of the retained widgets. A widget owns a rectangle of the screen
+ * and only repaints it when its content changed. Widgets can have children,
+ * a repainted widget repaints all of them. Siblings should not overlap.
+ */
+class OLEDWidget {
+  public:
+    OLEDWidget(int16_t x, int16_t y, uint16_t width, uint16_t height);
+    virtual ~OLEDWidget() {};
+
+    /**
+     * Append a child widget, it is drawn after its parent.
+     */
+    void add(OLEDWidget *child);
+
+    /**
+     * Move or resize the widget. A child repaints its parent, a
+     * top level widget clears its old area.
+     */
+    void setBounds(int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+    /**
+     * Force a repaint on the next update.
+     */
+    void invalidate();
+
+    bool isDirty() const { return dirty; };
+
+    /**
+     * Repaint all dirty widgets of this tree into the display buffer
+     * and send the changes to the display. Returns false if nothing changed.
+     */
+    bool update(OLEDDisplay *display);
+
+    /**
+     * Repaint all dirty widgets of this tree into the display buffer without
+     * calling display(). Returns false if nothing changed.
+     */
+    bool paintTree(OLEDDisplay *display);
+
+    int16_t  x;
+    int16_t  y;
+    uint16_t width;
+    uint16_t height;
+
+  protected:
+    // Draw the content of the widget, the area is already cleared
+    virtual void paint(OLEDDisplay *display) {(void)display;};
+
+    // Called instead of paint() when the widget isn't dirty, lets a widget update
+    // what is already in the display buffer. Returns true if it drew anything.
+    virtual bool paintChanges(OLEDDisplay *display) {(void)display; return false;};
+
+    bool        dirty;
+
+    OLEDWidget *firstChild;
+    OLEDWidget *nextSibling;
+    OLEDWidget *parent;
+
+  private:
+    bool        paintSubtree(OLEDDisplay *display, bool force);
+
+    // Area of the last paint that has to be cleared after setBounds()
+    int16_t     oldX, oldY;
+    uint16_t    oldWidth, oldHeight;
+};
+
+/**
+ * Text with the given font and alignment within the widget's area.
+ */
+class OLEDLabelWidget : public OLEDWidget {
+  public:
+    OLEDLabelWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, const char *text = "",
+                    const uint16_t *font = NULL, OLEDDISPLAY_TEXT_ALIGNMENT alignment = TEXT_ALIGN_LEFT);
+
+    void setText(const char *text);
+    const char *getText() const { return text; };
+    void setFont(const uint16_t *font);
+    void setAlignment(OLEDDISPLAY_TEXT_ALIGNMENT alignment);
+
+  protected:
+    void paint(OLEDDisplay *display);
+    // Draw text like the label, the font and alignment of the display are kept
+    void paintText(OLEDDisplay *display, const char *text);
+
+    char                        text[OLEDWIDGET_TEXT_LENGTH];
+    const uint16_t             *font;
+    OLEDDISPLAY_TEXT_ALIGNMENT  alignment;
+};
+
+/**
+ * A number with a fixed number of decimals and an optional unit, e.g.
+ * setValue(2315) with 2 decimals and unit "V" shows "23.15V".
+ */
+class OLEDValueWidget : public OLEDLabelWidget {
+  public:
+    OLEDValueWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t decimals = 0,
+                    const char *unit = NULL, const uint16_t *font = NULL,
+                    OLEDDISPLAY_TEXT_ALIGNMENT alignment = TEXT_ALIGN_RIGHT);
+
+    void setValue(int32_t value);
+    int32_t getValue() const { return value; };
+
+  protected:
+    void paint(OLEDDisplay *display);
+
+    int32_t     value;
+    uint8_t     decimals;
+    const char *unit;
+};
+
+/**
+ * A XBM image of the widget's size.
+ */
+class OLEDIconWidget : public OLEDWidget {
+  public:
+    OLEDIconWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *xbm = NULL);
+
+    void setIcon(const uint8_t *xbm);
+
+  protected:
+    void paint(OLEDDisplay *display);
+
+    const uint8_t *xbm;
+};
+
+/**
+ * A horizontal bar filled to the given percentage.
+ */
+class OLEDBarWidget : public OLEDWidget {
+  public:
+    OLEDBarWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t progress = 0);
+
+    // Progress is a value between 0 and 100
+    void setProgress(uint8_t progress);
+    uint8_t getProgress() const { return progress; };
+
+  protected:
+    void paint(OLEDDisplay *display);
+
+    uint8_t progress;
+};
+
+/**
+ * A half circle dial with a needle pointing to the given percentage.
+ */
+class OLEDGaugeWidget : public OLEDBarWidget {
+  public:
+    OLEDGaugeWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t progress = 0);
+
+  protected:
+    void paint(OLEDDisplay *display);
+};
+
+/**
+ * A line chart of the last `width` samples, one sample per column, the newest on the
+ * right. Appending a sample shifts the plotted area in the display buffer one column
+ * to the left and only draws the new column.
+ */
+class OLEDChartWidget : public OLEDWidget {
+  public:
+    // Samples are clamped to minValue..maxValue which map to the bottom and the top row
+    OLEDChartWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, int16_t minValue, int16_t maxValue);
+    ~OLEDChartWidget();
+
+    void addSample(int16_t value);
+
+    // Remove all samples
+    void clearSamples();
+
+    uint16_t getSampleCount() const { return count; };
+
+  protected:
+    void paint(OLEDDisplay *display);
+    bool paintChanges(OLEDDisplay *display);
+
+    // Column of the sample at the given age (0 = newest) and the row of a value
+    void drawSample(OLEDDisplay *display, uint16_t age);
+    int16_t valueToRow(int16_t value);
+
+    // Move the plotted area in the display buffer to the left
+    void scrollLeft(OLEDDisplay *display, uint16_t columns);
+
+    int16_t  *samples;
+    uint16_t  capacity;
+    uint16_t  count;
+    uint16_t  head;
+    uint16_t  pendingSamples;
+    int16_t   minValue;
+    int16_t   maxValue;
+};
+
+/**
+ * Text that scrolls through the widget by whole pixels, as a ticker on one line or
+ * wrapped to the widget's width and moving up. The text is rendered once into an
+ * off-screen strip, each frame only copies the visible window of it.
+ */
+class OLEDScrollTextWidget : public OLEDWidget {
+  public:
+    // After the text follows an empty gap of gap pixels, then it starts again
+    OLEDScrollTextWidget(int16_t x, int16_t y, uint16_t width, uint16_t height, const char *text = NULL,
+                         const uint16_t *font = NULL, bool vertical = false, uint16_t gap = 16);
+    ~OLEDScrollTextWidget();
+
+    // The text is not copied, it is rendered on the next paint and must be valid until then
+    void setText(const char *text);
+    void setFont(const uint16_t *font);
+
+    // Move the text left (ticker) or up (vertical) by the given pixels, negative values move it back
+    void scroll(int16_t pixels);
+
+    void setScrollPosition(uint16_t position);
+    uint16_t getScrollPosition() const { return position; };
+
+    // Pixels to scroll until the text repeats, 0 before the first paint
+    uint16_t getContentLength() const { return vertical ? stripHeight : stripWidth; };
+
+  protected:
+    void paint(OLEDDisplay *display);
+
+    // Render the text into the strip, the font and alignment of the display are kept
+    void render(OLEDDisplay *display);
+    void renderStrip(OLEDDisplay *display);
+
+    const char     *text;
+    const uint16_t *font;
+    bool            vertical;
+    uint16_t        gap;
+    uint16_t        position;
+
+    // Off-screen copy of the text with the layout of the display buffer, NULL until rendered
+    uint8_t        *strip;
+    uint16_t        stripWidth;
+    uint16_t        stripHeight;
+};
+
+#endif
@@ -60,81 +60,46 @@ class SH1106Brzo : public OLEDDisplay {
       return true;
     }
 
-    void display(void) {
-    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-       uint8_t minBoundY = UINT8_MAX;
-       uint8_t maxBoundY = 0;
-
-       uint8_t minBoundX = UINT8_MAX;
-       uint8_t maxBoundX = 0;
-       uint8_t x, y;
-
-       // Calculate the Y bounding box of changes
-       // and copy buffer[pos] to buffer_back[pos];
-       for (y = 0; y < (displayHeight / 8); y++) {
-         for (x = 0; x < displayWidth; x++) {
-          uint16_t pos = x + y * displayWidth;
-          if (buffer[pos] != buffer_back[pos]) {
-            minBoundY = _min(minBoundY, y);
-            maxBoundY = _max(maxBoundY, y);
-            minBoundX = _min(minBoundX, x);
-            maxBoundX = _max(maxBoundX, x);
-          }
-          buffer_back[pos] = buffer[pos];
-        }
-        yield();
-       }
-
-       // If the minBoundY wasn't updated
-       // we can savely assume that buffer_back[pos] == buffer[pos]
-       // holdes true for all values of pos
-       if (minBoundY == UINT8_MAX) return;
+  private:
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
+       // Calculate the colum offset
+       sendCommand(0xB0 + page);
+       sendCommand((minX + 2) & 0x0F);
+       sendCommand(0x10 | ((minX + 2) >> 4));
 
+       // Page addressing, every page starts with its own commands so writes end at the page
        uint8_t k = 0;
        uint8_t sendBuffer[17];
        sendBuffer[0] = 0x40;
-
-       // Calculate the colum offset
-       uint8_t minBoundXp2H = (minBoundX + 2) & 0x0F;
-       uint8_t minBoundXp2L = 0x10 | ((minBoundX + 2) >> 4 );
-
        brzo_i2c_start_transaction(this->_address, BRZO_I2C_SPEED);
-
-       for (y = minBoundY; y <= maxBoundY; y++) {
-         sendCommand(0xB0 + y);
-         sendCommand(minBoundXp2H);
-         sendCommand(minBoundXp2L);
-         for (x = minBoundX; x <= maxBoundX; x++) {
-             k++;
-             sendBuffer[k] = buffer[x + y * displayWidth];
-             if (k == 16)  {
-               brzo_i2c_write(sendBuffer, 17, true);
-               k = 0;
-             }
-         }
-         if (k != 0) {
-           brzo_i2c_write(sendBuffer, k + 1, true);
+       for (uint16_t x = minX; x <= maxX; x++) {
+         k++;
+         sendBuffer[k] = transferFrame[x + page * displayWidth];
+         if (k == 16)  {
+           brzo_i2c_write(sendBuffer, 17, true);
+           countBusTransaction(17);
            k = 0;
          }
-         yield();
        }
        if (k != 0) {
          brzo_i2c_write(sendBuffer, k + 1, true);
+         countBusTransaction(k + 1);
        }
        brzo_i2c_end_transaction();
-     #else
-     #endif
     }
 
-  private:
 	int getBufferOffset(void) {
 		return 0;
 	}
+    // The SH1106 has no scroll commands
+    bool supportsHardwareScroll() { return false; }
     inline void sendCommand(uint8_t com) __attribute__((always_inline)){
       uint8_t command[2] = {0x80 /* command mode */, com};
       brzo_i2c_start_transaction(_address, BRZO_I2C_SPEED);
       brzo_i2c_write(command, 2, true);
       brzo_i2c_end_transaction();
+      traceCommand(com);
+      countBusTransaction(2);
     }
 };
 
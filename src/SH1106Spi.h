@@ -69,75 +69,28 @@ class SH1106Spi : public OLEDDisplay {
       return true;
     }
 
-    void display(void) {
-    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-       uint8_t minBoundY = UINT8_MAX;
-       uint8_t maxBoundY = 0;
-
-       uint8_t minBoundX = UINT8_MAX;
-       uint8_t maxBoundX = 0;
-
-       uint8_t x, y;
-
-       // Calculate the Y bounding box of changes
-       // and copy buffer[pos] to buffer_back[pos];
-       for (y = 0; y < (displayHeight / 8); y++) {
-         for (x = 0; x < displayWidth; x++) {
-          uint16_t pos = x + y * displayWidth;
-          if (buffer[pos] != buffer_back[pos]) {
-            minBoundY = _min(minBoundY, y);
-            maxBoundY = _max(maxBoundY, y);
-            minBoundX = _min(minBoundX, x);
-            maxBoundX = _max(maxBoundX, x);
-          }
-          buffer_back[pos] = buffer[pos];
-        }
-        yield();
-       }
-
-       // If the minBoundY wasn't updated
-       // we can savely assume that buffer_back[pos] == buffer[pos]
-       // holdes true for all values of pos
-       if (minBoundY == UINT8_MAX) return;
-
+  private:
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
        // Calculate the colum offset
-       uint8_t minBoundXp2H = (minBoundX + 2) & 0x0F;
-       uint8_t minBoundXp2L = 0x10 | ((minBoundX + 2) >> 4 );
-
-       for (y = minBoundY; y <= maxBoundY; y++) {
-         sendCommand(0xB0 + y);
-         sendCommand(minBoundXp2H);
-         sendCommand(minBoundXp2L);
-         set_CS(HIGH);
-         digitalWrite(_dc, HIGH);   // data mode
-         set_CS(LOW);
-         for (x = minBoundX; x <= maxBoundX; x++) {
-           SPI.transfer(buffer[x + y * displayWidth]);
-         }
-         set_CS(HIGH);
-         yield();
+       sendCommand(0xB0 + page);
+       sendCommand((minX + 2) & 0x0F);
+       sendCommand(0x10 | ((minX + 2) >> 4));
+
+       set_CS(HIGH);
+       digitalWrite(_dc, HIGH);   // data mode
+       set_CS(LOW);
+       for (uint16_t x = minX; x <= maxX; x++) {
+         SPI.transfer(transferFrame[x + page * displayWidth]);
        }
-     #else
-      for (uint8_t y=0; y<displayHeight/8; y++) {
-        sendCommand(0xB0 + y);
-        sendCommand(0x02);
-        sendCommand(0x10);
-        set_CS(HIGH);
-        digitalWrite(_dc, HIGH);   // data mode
-        set_CS(LOW);
-        for( uint8_t x=0; x < displayWidth; x++) {
-          SPI.transfer(buffer[x + y * displayWidth]);
-        }
-        set_CS(HIGH);
-        yield();
-      }
-     #endif
+       set_CS(HIGH);
+       countBusTransaction(maxX - minX + 1);
     }
 
-  private:
 	int getBufferOffset(void) {
 		return 0;
 	}
+    // The SH1106 has no scroll commands
+    bool supportsHardwareScroll() { return false; }
     inline void set_CS(bool level) {
       if (_cs != (uint8_t) -1) {
         digitalWrite(_cs, level);
@@ -149,6 +102,8 @@ class SH1106Spi : public OLEDDisplay {
       set_CS(LOW);
       SPI.transfer(com);
       set_CS(HIGH);
+      traceCommand(com);
+      countBusTransaction(1);
     }
 };
 
@@ -100,100 +100,51 @@ class SH1106Wire : public OLEDDisplay {
       return true;
     }
 
-    void display(void) {
-      initI2cIfNeccesary();
-      #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-        uint8_t minBoundY = UINT8_MAX;
-        uint8_t maxBoundY = 0;
-
-        uint8_t minBoundX = UINT8_MAX;
-        uint8_t maxBoundX = 0;
-
-        uint8_t x, y;
-
-        // Calculate the Y bounding box of changes
-        // and copy buffer[pos] to buffer_back[pos];
-        for (y = 0; y < (displayHeight / 8); y++) {
-          for (x = 0; x < displayWidth; x++) {
-           uint16_t pos = x + y * displayWidth;
-           if (buffer[pos] != buffer_back[pos]) {
-             minBoundY = _min(minBoundY, y);
-             maxBoundY = _max(maxBoundY, y);
-             minBoundX = _min(minBoundX, x);
-             maxBoundX = _max(maxBoundX, x);
-           }
-           buffer_back[pos] = buffer[pos];
-         }
-         yield();
-        }
-
-        // If the minBoundY wasn't updated
-        // we can savely assume that buffer_back[pos] == buffer[pos]
-        // holdes true for all values of pos
-        if (minBoundY == UINT8_MAX) return;
-
-        // Calculate the colum offset
-        uint8_t minBoundXp2H = (minBoundX + 2) & 0x0F;
-        uint8_t minBoundXp2L = 0x10 | ((minBoundX + 2) >> 4 );
+    void setI2cAutoInit(bool doI2cAutoInit) {
+      _doI2cAutoInit = doI2cAutoInit;
+    }
 
-        uint8_t k = 0;
-        for (y = minBoundY; y <= maxBoundY; y++) {
-          sendCommand(0xB0 + y);
-          sendCommand(minBoundXp2H);
-          sendCommand(minBoundXp2L);
-          for (x = minBoundX; x <= maxBoundX; x++) {
-            if (k == 0) {
-              _wire->beginTransmission(_address);
-              _wire->write(0x40);
-            }
-            _wire->write(buffer[x + y * displayWidth]);
-            k++;
-            if (k == I2C_OLED_TRANSFER_BYTE)  {
-              _wire->endTransmission();
-              k = 0;
-            }
-          }
-          if (k != 0)  {
-            _wire->endTransmission();
-            k = 0;
-          }
-          yield();
+  private:
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
+      initI2cIfNeccesary();
+      // Calculate the colum offset
+      sendCommand(0xB0 + page);
+      sendCommand((minX + 2) & 0x0F);
+      sendCommand(0x10 | ((minX + 2) >> 4));
+
+      // Page addressing, every page starts with its own commands so writes end at the page
+      uint8_t k = 0;
+      for (uint16_t x = minX; x <= maxX; x++) {
+        if (k == 0) {
+          _wire->beginTransmission(_address);
+          _wire->write(0x40);
         }
-
-        if (k != 0) {
+        _wire->write(transferFrame[x + page * displayWidth]);
+        k++;
+        if (k == I2C_OLED_TRANSFER_BYTE)  {
           _wire->endTransmission();
+          countBusTransaction(k + 1);
+          k = 0;
         }
-      #else
-        uint8_t * p = &buffer[0];
-        for (uint8_t y=0; y<8; y++) {
-          sendCommand(0xB0+y);
-          sendCommand(0x02);
-          sendCommand(0x10);
-          for( uint8_t x=0; x<(128/I2C_OLED_TRANSFER_BYTE); x++) {
-            _wire->beginTransmission(_address);
-            _wire->write(0x40);
-            for (uint8_t k = 0; k < I2C_OLED_TRANSFER_BYTE; k++) {
-              _wire->write(*p++);
-            }
-            _wire->endTransmission();
-          }
-        }
-      #endif
-    }
-
-    void setI2cAutoInit(bool doI2cAutoInit) {
-      _doI2cAutoInit = doI2cAutoInit;
+      }
+      if (k != 0)  {
+        _wire->endTransmission();
+        countBusTransaction(k + 1);
+      }
     }
 
-  private:
 	int getBufferOffset(void) {
 		return 0;
 	}
+    // The SH1106 has no scroll commands
+    bool supportsHardwareScroll() { return false; }
     inline void sendCommand(uint8_t command) __attribute__((always_inline)){
       _wire->beginTransmission(_address);
       _wire->write(0x80);
       _wire->write(command);
       _wire->endTransmission();
+      traceCommand(command);
+      countBusTransaction(2);
     }
 
     void initI2cIfNeccesary() {
@@ -45,6 +45,10 @@ class SSD1306Brzo : public OLEDDisplay {
       uint8_t             _address;
       uint8_t             _sda;
       uint8_t             _scl;
+      // Data of the transfer not sent yet behind the 0x40 control byte,
+      // a write continues across pages
+      uint8_t             _sendBuffer[17];
+      uint8_t             _pendingLength = 0;
 
   public:
     SSD1306Brzo(uint8_t address, uint8_t sda, uint8_t scl, OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64) {
@@ -60,99 +64,51 @@ class SSD1306Brzo : public OLEDDisplay {
       return true;
     }
 
-    void display(void) {
-      const int x_offset = (128 - this->width()) / 2;
-
-    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-       uint8_t minBoundY = UINT8_MAX;
-       uint8_t maxBoundY = 0;
-
-       uint8_t minBoundX = UINT8_MAX;
-       uint8_t maxBoundX = 0;
-
-       uint8_t x, y;
-
-       // Calculate the Y bounding box of changes
-       // and copy buffer[pos] to buffer_back[pos];
-       for (y = 0; y < (this->height() / 8); y++) {
-         for (x = 0; x < this->width(); x++) {
-          uint16_t pos = x + y * this->width();
-          if (buffer[pos] != buffer_back[pos]) {
-            minBoundY = _min(minBoundY, y);
-            maxBoundY = _max(maxBoundY, y);
-            minBoundX = _min(minBoundX, x);
-            maxBoundX = _max(maxBoundX, x);
-          }
-          buffer_back[pos] = buffer[pos];
-        }
-        yield();
+  private:
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
+       if (page == transferMinPage) {
+         // Horizontal addressing mode, the controller continues on the next page by itself
+         const int x_offset = (128 - this->width()) / 2;
+         sendCommand(COLUMNADDR);
+         sendCommand(x_offset + minX);
+         sendCommand(x_offset + maxX);
+
+         sendCommand(PAGEADDR);
+         sendCommand(transferMinPage);
+         sendCommand(transferMaxPage);
        }
 
-       // If the minBoundY wasn't updated
-       // we can savely assume that buffer_back[pos] == buffer[pos]
-       // holdes true for all values of pos
-       if (minBoundY == UINT8_MAX) return;
-
-       sendCommand(COLUMNADDR);
-       sendCommand(x_offset + minBoundX);
-       sendCommand(x_offset + maxBoundX);
-
-       sendCommand(PAGEADDR);
-       sendCommand(minBoundY);
-       sendCommand(maxBoundY);
-
-       uint8_t k = 0;
-
-       int buflen = ( this->width() / 8 ) + 1;
-
-       uint8_t sendBuffer[buflen];
-       sendBuffer[0] = 0x40;
-       brzo_i2c_start_transaction(this->_address, BRZO_I2C_SPEED);
-       for (y = minBoundY; y <= maxBoundY; y++) {
-           for (x = minBoundX; x <= maxBoundX; x++) {
-               k++;
-               sendBuffer[k] = buffer[x + y * this->width()];
-               if (k == (buflen-1))  {
-                 brzo_i2c_write(sendBuffer, buflen, true);
-                 k = 0;
-               }
+       if (page == transferMinPage) {
+         _pendingLength = 0;
+       }
+       _sendBuffer[0] = 0x40;
+       bool started = false;
+       for (uint16_t x = minX; x <= maxX; x++) {
+         _sendBuffer[++_pendingLength] = transferFrame[x + page * this->width()];
+         if (_pendingLength == 16)  {
+           if (!started) {
+             brzo_i2c_start_transaction(this->_address, BRZO_I2C_SPEED);
+             started = true;
            }
-           yield();
+           brzo_i2c_write(_sendBuffer, 17, true);
+           countBusTransaction(17);
+           _pendingLength = 0;
+         }
        }
-       brzo_i2c_write(sendBuffer, k + 1, true);
-       brzo_i2c_end_transaction();
-     #else
-       // No double buffering
-       sendCommand(COLUMNADDR);
-
-       sendCommand(x_offset);
-       sendCommand(x_offset + (this->width() - 1));
-
-       sendCommand(PAGEADDR);
-       sendCommand(0x0);
-       sendCommand((this->height() / 8) - 1);
-
-       int buflen = ( this->width() / 8 ) + 1;
-
-       uint8_t sendBuffer[buflen];
-       sendBuffer[0] = 0x40;
-
-       brzo_i2c_start_transaction(this->_address, BRZO_I2C_SPEED);
-
-       for (uint16_t i=0; i<displayBufferSize; i++) {
-         for (uint8_t x=1; x<buflen; x++) {
-           sendBuffer[x] = buffer[i];
-           i++;
+       if (page == transferMaxPage && _pendingLength != 0) {
+         if (!started) {
+           brzo_i2c_start_transaction(this->_address, BRZO_I2C_SPEED);
+           started = true;
          }
-         i--;
-         brzo_i2c_write(sendBuffer,  buflen,  true);
-         yield();
+         brzo_i2c_write(_sendBuffer, _pendingLength + 1, true);
+         countBusTransaction(_pendingLength + 1);
+         _pendingLength = 0;
+       }
+       if (started) {
+         brzo_i2c_end_transaction();
        }
-       brzo_i2c_end_transaction();
-     #endif
     }
 
-  private:
 	int getBufferOffset(void) {
 		return 0;
 	}
@@ -161,6 +117,8 @@ class SSD1306Brzo : public OLEDDisplay {
       brzo_i2c_start_transaction(_address, BRZO_I2C_SPEED);
       brzo_i2c_write(command, 2, true);
       brzo_i2c_end_transaction();
+      traceCommand(com);
+      countBusTransaction(2);
     }
 };
 
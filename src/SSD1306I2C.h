@@ -61,75 +61,30 @@ public:
       return true;
     }
 
-    void display(void) {
-      const int x_offset = (128 - this->width()) / 2;
-#ifdef OLEDDISPLAY_DOUBLE_BUFFER
-        uint8_t minBoundY = UINT8_MAX;
-        uint8_t maxBoundY = 0;
-
-        uint8_t minBoundX = UINT8_MAX;
-        uint8_t maxBoundX = 0;
-        uint8_t x, y;
-
-        // Calculate the Y bounding box of changes
-        // and copy buffer[pos] to buffer_back[pos];
-        for (y = 0; y < (this->height() / 8); y++) {
-          for (x = 0; x < this->width(); x++) {
-           uint16_t pos = x + y * this->width();
-           if (buffer[pos] != buffer_back[pos]) {
-             minBoundY = std::min(minBoundY, y);
-             maxBoundY = std::max(maxBoundY, y);
-             minBoundX = std::min(minBoundX, x);
-             maxBoundX = std::max(maxBoundX, x);
-           }
-           buffer_back[pos] = buffer[pos];
-         }
-         yield();
-        }
-
-        // If the minBoundY wasn't updated
-        // we can savely assume that buffer_back[pos] == buffer[pos]
-        // holdes true for all values of pos
-
-        if (minBoundY == UINT8_MAX) return;
-
-        sendCommand(COLUMNADDR);
-        sendCommand(x_offset + minBoundX);	// column start address (0 = reset)
-        sendCommand(x_offset + maxBoundX);	// column end address (127 = reset)
-
-        sendCommand(PAGEADDR);
-        sendCommand(minBoundY);				// page start address
-        sendCommand(maxBoundY);				// page end address
-
-        for (y = minBoundY; y <= maxBoundY; y++) {
-			uint8_t *start = &buffer[(minBoundX + y * this->width())-1];
-			uint8_t save = *start;
-			
-			*start = 0x40; // control
-			_i2c->write(_address, (char *)start, (maxBoundX-minBoundX) + 1 + 1);
-			*start = save;
-		}
-#else
-
+private:
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
+      if (page == transferMinPage) {
+        // Horizontal addressing mode, the controller continues on the next page by itself
+        const int x_offset = (128 - this->width()) / 2;
         sendCommand(COLUMNADDR);
-        sendCommand(x_offset);						// column start address (0 = reset)
-        sendCommand(x_offset + (this->width() - 1));// column end address (127 = reset)
+        sendCommand(x_offset + minX);	// column start address (0 = reset)
+        sendCommand(x_offset + maxX);	// column end address (127 = reset)
 
         sendCommand(PAGEADDR);
-        sendCommand(0x0);							// page start address (0 = reset)
-
-        if (geometry == GEOMETRY_128_64) {
-          sendCommand(0x7);
-        } else if (geometry == GEOMETRY_128_32) {
-          sendCommand(0x3);
-        }
-
-		buffer[-1] = 0x40; // control
-		_i2c->write(_address, (char *)&buffer[-1], displayBufferSize + 1);
-#endif
+        sendCommand(transferMinPage);		// page start address
+        sendCommand(transferMaxPage);		// page end address
+      }
+
+      // The byte before the span is temporarily replaced by the control byte
+      uint8_t *start = &transferFrame[(minX + page * this->width()) - 1];
+      uint8_t save = *start;
+
+      *start = 0x40; // control
+      _i2c->write(_address, (char *)start, (maxX - minX) + 1 + 1);
+      *start = save;
+      countBusTransaction((maxX - minX) + 1 + 1);
     }
 
-private:
 	int getBufferOffset(void) {
 		return 0;
 	}
@@ -139,6 +94,8 @@ private:
 	  	_data[0] = 0x80; // control
 	  	_data[1] = command;
 	  	_i2c->write(_address, _data, sizeof(_data));
+	  	traceCommand(command);
+	  	countBusTransaction(sizeof(_data));
     }
 
 	uint8_t             _address;
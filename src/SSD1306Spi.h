@@ -75,82 +75,29 @@ class SSD1306Spi : public OLEDDisplay {
       return true;
     }
 
-    void display(void) {
-    #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-       uint8_t minBoundY = UINT8_MAX;
-       uint8_t maxBoundY = 0;
-
-       uint8_t minBoundX = UINT8_MAX;
-       uint8_t maxBoundX = 0;
-
-       uint8_t x, y;
-
-       // Calculate the Y bounding box of changes
-       // and copy buffer[pos] to buffer_back[pos];
-       for (y = 0; y < (displayHeight / 8); y++) {
-         for (x = 0; x < displayWidth; x++) {
-          uint16_t pos = x + y * displayWidth;
-          if (buffer[pos] != buffer_back[pos]) {
-            minBoundY = _min(minBoundY, y);
-            maxBoundY = _max(maxBoundY, y);
-            minBoundX = _min(minBoundX, x);
-            maxBoundX = _max(maxBoundX, x);
-          }
-          buffer_back[pos] = buffer[pos];
-        }
-        yield();
+  private:
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
+       if (page == transferMinPage) {
+         // Horizontal addressing mode, the controller continues on the next page by itself
+         sendCommand(COLUMNADDR);
+         sendCommand(minX);
+         sendCommand(maxX);
+
+         sendCommand(PAGEADDR);
+         sendCommand(transferMinPage);
+         sendCommand(transferMaxPage);
        }
 
-       // If the minBoundY wasn't updated
-       // we can savely assume that buffer_back[pos] == buffer[pos]
-       // holdes true for all values of pos
-       if (minBoundY == UINT8_MAX) return;
-
-       sendCommand(COLUMNADDR);
-       sendCommand(minBoundX);
-       sendCommand(maxBoundX);
-
-       sendCommand(PAGEADDR);
-       sendCommand(minBoundY);
-       sendCommand(maxBoundY);
-
        set_CS(HIGH);
        digitalWrite(_dc, HIGH);   // data mode
        set_CS(LOW);
-       for (y = minBoundY; y <= maxBoundY; y++) {
-         for (x = minBoundX; x <= maxBoundX; x++) {
-           SPI.transfer(buffer[x + y * displayWidth]);
-         }
-         yield();
+       for (uint16_t x = minX; x <= maxX; x++) {
+         SPI.transfer(transferFrame[x + page * displayWidth]);
        }
        set_CS(HIGH);
-     #else
-       // No double buffering
-       sendCommand(COLUMNADDR);
-       sendCommand(0x0);
-       sendCommand(0x7F);
-
-       sendCommand(PAGEADDR);
-       sendCommand(0x0);
-
-       if (geometry == GEOMETRY_128_64 || geometry == GEOMETRY_64_48 || geometry == GEOMETRY_64_32 ) {
-         sendCommand(0x7);
-       } else if (geometry == GEOMETRY_128_32) {
-         sendCommand(0x3);
-       }
-
-        set_CS(HIGH);
-        digitalWrite(_dc, HIGH);   // data mode
-        set_CS(LOW);
-        for (uint16_t i=0; i<displayBufferSize; i++) {
-          SPI.transfer(buffer[i]);
-          yield();
-        }
-        set_CS(HIGH);
-     #endif
+       countBusTransaction(maxX - minX + 1);
     }
 
-  private:
 	int getBufferOffset(void) {
 		return 0;
 	}
@@ -165,6 +112,8 @@ class SSD1306Spi : public OLEDDisplay {
       set_CS(LOW);
       SPI.transfer(com);
       set_CS(HIGH);
+      traceCommand(com);
+      countBusTransaction(1);
     }
 };
 
@@ -54,6 +54,9 @@ class SSD1306Wire : public OLEDDisplay {
       bool                _doI2cAutoInit = false;
       TwoWire*            _wire = NULL;
       long                _frequency;
+      // Data bytes of the transfer not sent yet, a write continues across pages
+      uint8_t             _pending[I2C_MAX_TRANSFER_BYTE - 1];
+      uint8_t             _pendingLength = 0;
 
   public:
 
@@ -101,95 +104,51 @@ class SSD1306Wire : public OLEDDisplay {
       return true;
     }
 
-    void display(void) {
-      initI2cIfNeccesary();
-      const int x_offset = (128 - this->width()) / 2;
-      #ifdef OLEDDISPLAY_DOUBLE_BUFFER
-        uint8_t minBoundY = UINT8_MAX;
-        uint8_t maxBoundY = 0;
-
-        uint8_t minBoundX = UINT8_MAX;
-        uint8_t maxBoundX = 0;
-        uint8_t x, y;
-
-        // Calculate the Y bounding box of changes
-        // and copy buffer[pos] to buffer_back[pos];
-        for (y = 0; y < (this->height() / 8); y++) {
-          for (x = 0; x < this->width(); x++) {
-           uint16_t pos = x + y * this->width();
-           if (buffer[pos] != buffer_back[pos]) {
-             minBoundY = std::min(minBoundY, y);
-             maxBoundY = std::max(maxBoundY, y);
-             minBoundX = std::min(minBoundX, x);
-             maxBoundX = std::max(maxBoundX, x);
-           }
-           buffer_back[pos] = buffer[pos];
-         }
-         yield();
-        }
-
-        // If the minBoundY wasn't updated
-        // we can savely assume that buffer_back[pos] == buffer[pos]
-        // holdes true for all values of pos
-
-        if (minBoundY == UINT8_MAX) return;
+    void setI2cAutoInit(bool doI2cAutoInit) {
+      _doI2cAutoInit = doI2cAutoInit;
+    }
 
+  private:
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
+      if (page == transferMinPage) {
+        initI2cIfNeccesary();
+        // Horizontal addressing mode, the controller continues on the next page by itself
+        const int x_offset = (128 - this->width()) / 2;
         sendCommand(COLUMNADDR);
-        sendCommand(x_offset + minBoundX);
-        sendCommand(x_offset + maxBoundX);
+        sendCommand(x_offset + minX);
+        sendCommand(x_offset + maxX);
 
         sendCommand(PAGEADDR);
-        sendCommand(minBoundY);
-        sendCommand(maxBoundY);
-
-        uint8_t k = 0;
-        for (y = minBoundY; y <= maxBoundY; y++) {
-          for (x = minBoundX; x <= maxBoundX; x++) {
-            if (k == 0) {
-              _wire->beginTransmission(_address);
-              _wire->write(0x40);
-            }
-
-            _wire->write(buffer[x + y * this->width()]);
-            k++;
-            if (k == (I2C_MAX_TRANSFER_BYTE - 1))  {
-              _wire->endTransmission();
-              k = 0;
-            }
-          }
-          yield();
-        }
+        sendCommand(transferMinPage);
+        sendCommand(transferMaxPage);
+        _pendingLength = 0;
+      }
 
-        if (k != 0) {
-          _wire->endTransmission();
+      for (uint16_t x = minX; x <= maxX; x++) {
+        _pending[_pendingLength++] = transferFrame[x + page * this->width()];
+        if (_pendingLength == (I2C_MAX_TRANSFER_BYTE - 1))  {
+          sendPending();
         }
-      #else
-
-        sendCommand(COLUMNADDR);
-        sendCommand(x_offset);
-        sendCommand(x_offset + (this->width() - 1));
+      }
 
-        sendCommand(PAGEADDR);
-        sendCommand(0x0);
-
-        for (uint16_t i=0; i < displayBufferSize; i++) {
-          _wire->beginTransmission(this->_address);
-          _wire->write(0x40);
-          for (uint8_t x = 0; x < (I2C_MAX_TRANSFER_BYTE - 1); x++) {
-            _wire->write(buffer[i]);
-            i++;
-          }
-          i--;
-          _wire->endTransmission();
-        }
-      #endif
+      if (page == transferMaxPage && _pendingLength != 0) {
+        sendPending();
+      }
     }
 
-    void setI2cAutoInit(bool doI2cAutoInit) {
-      _doI2cAutoInit = doI2cAutoInit;
+    // Send the collected data bytes in one write, the controller continues
+    // on the next page by itself so a write may span pages
+    void sendPending() {
+      _wire->beginTransmission(_address);
+      _wire->write(0x40);
+      for (uint8_t i = 0; i < _pendingLength; i++) {
+        _wire->write(_pending[i]);
+      }
+      _wire->endTransmission();
+      countBusTransaction(_pendingLength + 1);
+      _pendingLength = 0;
     }
 
-  private:
 	int getBufferOffset(void) {
 		return 0;
 	}
@@ -199,6 +158,8 @@ class SSD1306Wire : public OLEDDisplay {
       _wire->write(0x80);
       _wire->write(command);
       _wire->endTransmission();
+      traceCommand(command);
+      countBusTransaction(2);
     }
 
     void initI2cIfNeccesary() {
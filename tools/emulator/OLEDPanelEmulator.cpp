@@ -0,0 +1,313 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#include "OLEDPanelEmulator.h"
+
+#include <string.h>
+
+OLEDPanelEmulator::OLEDPanelEmulator(OLEDPANEL_CONTROLLER controller, uint16_t width, uint16_t height) {
+  this->controller = controller;
+  this->width = width;
+  this->height = height;
+  this->columns = controller == PANEL_SH1106 ? 132 : 128;
+  this->columnOffset = controller == PANEL_SH1106 ? 2 : (128 - width) / 2;
+  memset(this->ram, 0, sizeof(this->ram));
+  reset();
+}
+
+void OLEDPanelEmulator::reset() {
+  // Power on values of both controllers
+  this->addressing = 2;
+  this->column = this->columnStart = this->pageColumnStart = 0;
+  this->columnEnd = this->columns - 1;
+  this->page = this->pageStart = 0;
+  this->pageEnd = 7;
+  this->argumentCount = 0;
+  this->argumentsLeft = 0;
+  this->startLine = 0;
+  this->displayOffset = 0;
+  this->multiplex = 64;
+  this->contrast = 0x7F;
+  this->segmentRemap = false;
+  this->comReverse = false;
+  this->inverted = false;
+  this->allOn = false;
+  this->displayOn = false;
+  this->scrolling = false;
+  this->scrollLeft = false;
+  this->scrollStartPage = 0;
+  this->scrollEndPage = 7;
+  this->scrollVerticalOffset = 0;
+  this->scrollFixedRows = 0;
+  this->scrollRows = 64;
+  this->verticalScroll = 0;
+  resetCounters();
+}
+
+void OLEDPanelEmulator::resetCounters() {
+  this->commandBytes = 0;
+  this->dataBytes = 0;
+  this->transactions = 0;
+  this->busBytes = 0;
+}
+
+void OLEDPanelEmulator::command(uint8_t command) {
+  this->commandBytes++;
+  if (this->argumentsLeft) {
+    this->arguments[this->argumentCount++] = command;
+    if (--this->argumentsLeft == 0) apply();
+    return;
+  }
+  this->arguments[0] = command;
+  this->argumentCount = 1;
+  this->argumentsLeft = argumentsOf(command);
+  if (this->argumentsLeft == 0) apply();
+}
+
+void OLEDPanelEmulator::data(const uint8_t *bytes, size_t length) {
+  this->dataBytes += length;
+  for (size_t i = 0; i < length; i++) {
+    // The controller ignores RAM writes while scrolling is active
+    if (!this->scrolling && this->page < 8 && this->column < this->columns) {
+      this->ram[this->page][this->column] = bytes[i];
+    }
+    advance();
+  }
+}
+
+void OLEDPanelEmulator::i2cWrite(const uint8_t *bytes, size_t length) {
+  this->transactions++;
+  this->busBytes += length;
+  size_t i = 0;
+  while (i < length) {
+    uint8_t control = bytes[i++];
+    bool    dataMode = control & 0x40;
+    if (control & 0x80) {
+      // Continuation bit set: one byte, then another control byte
+      if (i < length) {
+        if (dataMode) data(&bytes[i], 1);
+        else command(bytes[i]);
+        i++;
+      }
+    } else {
+      // The rest of the transaction
+      if (dataMode) {
+        data(&bytes[i], length - i);
+      } else {
+        for (; i < length; i++) command(bytes[i]);
+      }
+      break;
+    }
+  }
+}
+
+void OLEDPanelEmulator::spiWrite(bool dataMode, const uint8_t *bytes, size_t length) {
+  this->transactions++;
+  this->busBytes += length;
+  if (dataMode) {
+    data(bytes, length);
+  } else {
+    for (size_t i = 0; i < length; i++) command(bytes[i]);
+  }
+}
+
+uint8_t OLEDPanelEmulator::argumentsOf(uint8_t command) const {
+  switch (command) {
+    case 0x81: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 1;
+  }
+  if (this->controller == PANEL_SH1106) {
+    // DC-DC control mode
+    return command == 0xAD ? 1 : 0;
+  }
+  switch (command) {
+    case 0x20: case 0x8D:
+      return 1;
+    case 0x21: case 0x22: case 0xA3:
+      return 2;
+    case 0x29: case 0x2A:
+      return 5;
+    case 0x26: case 0x27:
+      return 6;
+  }
+  return 0;
+}
+
+void OLEDPanelEmulator::apply() {
+  uint8_t  command = this->arguments[0];
+  uint8_t *argument = this->arguments + 1;
+  bool     ssd1306 = this->controller == PANEL_SSD1306;
+
+  if (command <= 0x0F) {
+    this->pageColumnStart = (this->pageColumnStart & 0xF0) | command;
+    this->column = this->pageColumnStart;
+  } else if (command <= 0x1F) {
+    this->pageColumnStart = (this->pageColumnStart & 0x0F) | ((command & 0x0F) << 4);
+    this->column = this->pageColumnStart;
+  } else if (command >= 0x40 && command <= 0x7F) {
+    this->startLine = command & 0x3F;
+  } else if (command >= 0xB0 && command <= 0xB7) {
+    this->page = command & 0x07;
+  } else switch (command) {
+    case 0x81: this->contrast = argument[0]; break;
+    case 0xA0: this->segmentRemap = false; break;
+    case 0xA1: this->segmentRemap = true; break;
+    case 0xA4: this->allOn = false; break;
+    case 0xA5: this->allOn = true; break;
+    case 0xA6: this->inverted = false; break;
+    case 0xA7: this->inverted = true; break;
+    case 0xA8: this->multiplex = (argument[0] & 0x3F) + 1; break;
+    case 0xAE: this->displayOn = false; break;
+    case 0xAF: this->displayOn = true; break;
+    case 0xC0: this->comReverse = false; break;
+    case 0xC8: this->comReverse = true; break;
+    case 0xD3: this->displayOffset = argument[0] & 0x3F; break;
+  }
+  if (!ssd1306) return;
+
+  switch (command) {
+    case 0x20:
+      this->addressing = argument[0] & 0x03;
+      break;
+    case 0x21:
+      this->columnStart = this->column = argument[0] & 0x7F;
+      this->columnEnd = argument[1] & 0x7F;
+      break;
+    case 0x22:
+      this->pageStart = this->page = argument[0] & 0x07;
+      this->pageEnd = argument[1] & 0x07;
+      break;
+    case 0x26: case 0x27:
+      this->scrollLeft = command == 0x27;
+      this->scrollStartPage = argument[1] & 0x07;
+      this->scrollEndPage = argument[3] & 0x07;
+      this->scrollVerticalOffset = 0;
+      break;
+    case 0x29: case 0x2A:
+      this->scrollLeft = command == 0x2A;
+      this->scrollStartPage = argument[1] & 0x07;
+      this->scrollEndPage = argument[3] & 0x07;
+      this->scrollVerticalOffset = argument[4] & 0x3F;
+      break;
+    case 0xA3:
+      this->scrollFixedRows = argument[0] & 0x3F;
+      this->scrollRows = argument[1] & 0x7F;
+      break;
+    case 0x2E:
+      this->scrolling = false;
+      this->verticalScroll = 0;
+      break;
+    case 0x2F:
+      this->scrolling = true;
+      break;
+  }
+}
+
+void OLEDPanelEmulator::advance() {
+  if (this->controller == PANEL_SH1106) {
+    // The column stops at the end of the page
+    if (this->column < this->columns - 1) this->column++;
+  } else if (this->addressing >= 2) {
+    // Page addressing, the column wraps to the start address in the same page
+    this->column = this->column >= this->columns - 1 ? this->pageColumnStart : this->column + 1;
+  } else if (this->addressing == 0) {
+    if (this->column >= this->columnEnd) {
+      this->column = this->columnStart;
+      this->page = this->page >= this->pageEnd ? this->pageStart : this->page + 1;
+    } else {
+      this->column++;
+    }
+  } else {
+    if (this->page >= this->pageEnd) {
+      this->page = this->pageStart;
+      this->column = this->column >= this->columnEnd ? this->columnStart : this->column + 1;
+    } else {
+      this->page++;
+    }
+  }
+}
+
+void OLEDPanelEmulator::scrollStep() {
+  if (!this->scrolling) return;
+  for (uint8_t page = this->scrollStartPage; page <= this->scrollEndPage && page < 8; page++) {
+    uint8_t *row = this->ram[page];
+    if (this->scrollLeft) {
+      uint8_t first = row[0];
+      memmove(row, row + 1, this->columns - 1);
+      row[this->columns - 1] = first;
+    } else {
+      uint8_t last = row[this->columns - 1];
+      memmove(row + 1, row, this->columns - 1);
+      row[0] = last;
+    }
+  }
+  if (this->scrollVerticalOffset && this->scrollRows) {
+    this->verticalScroll = (this->verticalScroll + this->scrollVerticalOffset) % this->scrollRows;
+  }
+}
+
+uint8_t OLEDPanelEmulator::ramByte(uint8_t page, uint8_t column) const {
+  return page < 8 && column < this->columns ? this->ram[page][column] : 0;
+}
+
+bool OLEDPanelEmulator::ramPixel(uint16_t x, uint16_t y) const {
+  if (x >= this->width || y >= this->height) return false;
+  return ramByte(y / 8, x + this->columnOffset) & (1 << (y & 7));
+}
+
+bool OLEDPanelEmulator::screenPixel(uint16_t x, uint16_t y) const {
+  if (!this->displayOn || x >= this->width || y >= this->height || y >= this->multiplex) return false;
+  if (this->allOn) return true;
+
+  // Row of the COM output, then the RAM row it shows
+  uint8_t row = this->comReverse ? this->multiplex - 1 - y : y;
+  row = (row + this->displayOffset) & 0x3F;
+  if (this->verticalScroll && row >= this->scrollFixedRows && row < this->scrollFixedRows + this->scrollRows) {
+    row = this->scrollFixedRows + (row - this->scrollFixedRows + this->verticalScroll) % this->scrollRows;
+  }
+  row = (row + this->startLine) & 0x3F;
+
+  uint8_t column = x + this->columnOffset;
+  if (this->segmentRemap) column = this->columns - 1 - column;
+
+  bool on = this->ram[row / 8][column] & (1 << (row & 7));
+  return on != this->inverted;
+}
+
+uint32_t OLEDPanelEmulator::compare(const uint8_t *buffer) const {
+  uint32_t differences = 0;
+  for (uint16_t page = 0; page < this->height / 8; page++) {
+    for (uint16_t x = 0; x < this->width; x++) {
+      if (buffer[x + page * this->width] != ramByte(page, x + this->columnOffset)) differences++;
+    }
+  }
+  return differences;
+}
@@ -0,0 +1,210 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+#ifndef OLEDPANELEMULATOR_h
+#define OLEDPANELEMULATOR_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Software model of the SSD1306 and SH1106 controllers for the host. Feed it
+ * the command and data bytes a driver sends and it keeps the display RAM
+ * (GDDRAM) the way the controller would, so display() output can be checked
+ * against the frame buffer and its cost counted.
+ *
+ * Interpreted: page, horizontal and vertical addressing (MEMORYMODE,
+ * COLUMNADDR, PAGEADDR, 0xB0+page, low/high column), start line, display
+ * offset, segment remap, COM scan direction, inverse/all on, display on/off
+ * and the SSD1306 scroll commands. Other commands are skipped with their
+ * arguments.
+ */
+
+enum OLEDPANEL_CONTROLLER {
+  PANEL_SSD1306,   // 128 x 64 RAM
+  PANEL_SH1106     // 132 x 64 RAM, the visible columns start at 2
+};
+
+class OLEDPanelEmulator {
+  public:
+    // width and height of the visible area
+    OLEDPanelEmulator(OLEDPANEL_CONTROLLER controller, uint16_t width = 128, uint16_t height = 64);
+
+    // Power on state, clears the counters but not the RAM (like the controller)
+    void reset();
+
+    /* Bus input */
+
+    // One command byte / display RAM data
+    void command(uint8_t command);
+    void data(const uint8_t *bytes, size_t length);
+
+    // The bytes of one I2C write after the address, starting with a control byte
+    void i2cWrite(const uint8_t *bytes, size_t length);
+
+    // One SPI transfer with the D/C pin high (data) or low (commands)
+    void spiWrite(bool dataMode, const uint8_t *bytes, size_t length);
+
+    // Move scrolling pages by one step, as the controller does every scroll interval
+    void scrollStep();
+
+    /* State */
+
+    // A byte of the display RAM
+    uint8_t ramByte(uint8_t page, uint8_t column) const;
+
+    // Column of the RAM where the visible area starts, (128 - width) / 2 for
+    // the SSD1306 drivers, 2 for SH1106
+    uint8_t getColumnOffset() const { return columnOffset; };
+    void setColumnOffset(uint8_t offset) { columnOffset = offset; };
+
+    // Pixel of the RAM at the visible position, the way the frame buffer has it
+    bool ramPixel(uint16_t x, uint16_t y) const;
+
+    // Pixel as seen on the glass: with start line, offset, remapping, inverse, scrolling
+    bool screenPixel(uint16_t x, uint16_t y) const;
+
+    // Number of bytes of a page layout frame buffer (width x height) that differ from the RAM
+    uint32_t compare(const uint8_t *buffer) const;
+
+    bool isDisplayOn() const { return displayOn; };
+    bool isScrolling() const { return scrolling; };
+    uint8_t getContrast() const { return contrast; };
+
+    /* Counters since reset() or resetCounters() */
+    uint32_t commandBytes;   // command bytes, arguments included
+    uint32_t dataBytes;      // display RAM bytes
+    uint32_t transactions;   // i2cWrite() / spiWrite() calls
+    uint32_t busBytes;       // bytes of all transactions, control bytes included
+    void resetCounters();
+
+  private:
+    uint8_t argumentsOf(uint8_t command) const;
+    void    apply();
+    void    advance();
+
+    OLEDPANEL_CONTROLLER controller;
+    uint16_t width;
+    uint16_t height;
+    uint8_t  columns;
+    uint8_t  columnOffset;
+    uint8_t  ram[8][132];
+
+    // Address pointer
+    uint8_t  addressing;
+    uint8_t  column, columnStart, columnEnd;
+    uint8_t  pageColumnStart;   // set by the column nibble commands, for page addressing
+    uint8_t  page, pageStart, pageEnd;
+
+    // Command with arguments being received
+    uint8_t  arguments[8];
+    uint8_t  argumentCount;
+    uint8_t  argumentsLeft;
+
+    // Display settings
+    uint8_t  startLine;
+    uint8_t  displayOffset;
+    uint8_t  multiplex;
+    uint8_t  contrast;
+    bool     segmentRemap;
+    bool     comReverse;
+    bool     inverted;
+    bool     allOn;
+    bool     displayOn;
+
+    // Scrolling
+    bool     scrolling;
+    bool     scrollLeft;
+    uint8_t  scrollStartPage, scrollEndPage;
+    uint8_t  scrollVerticalOffset;
+    uint8_t  scrollFixedRows, scrollRows;
+    uint8_t  verticalScroll;
+};
+
+#ifdef OLEDDISPLAY_h
+/**
+ * Feeds what an OLEDDisplay sends into an emulator, for host builds of the
+ * library: display.setTraceSink(new OLEDPanelEmulatorSink(&panel))
+ */
+class OLEDPanelEmulatorSink : public OLEDDisplayTraceSink {
+  public:
+    OLEDPanelEmulatorSink(OLEDPanelEmulator *panel) : panel(panel) {};
+
+    void trace(OLEDDISPLAY_TRACE type, const uint8_t *bytes, uint16_t length) {
+      if (type == TRACE_COMMAND) panel->command(bytes[0]);
+      else if (type == TRACE_DATA) panel->data(bytes, length);
+    };
+
+  private:
+    OLEDPanelEmulator *panel;
+};
+
+/**
+ * A display on the host whose bus is an emulated SSD1306, sends like the
+ * SSD1306 I2C drivers (horizontal addressing, COLUMNADDR/PAGEADDR once per
+ * transfer). Lets the library, OLEDDisplayPipeline included, run on Linux.
+ */
+class OLEDPanelEmulatorDisplay : public OLEDDisplay {
+  public:
+    OLEDPanelEmulatorDisplay(OLEDPanelEmulator *panel, OLEDDISPLAY_GEOMETRY g = GEOMETRY_128_64) : panel(panel) {
+      setGeometry(g);
+    };
+
+  private:
+    bool connect() { return true; };
+    int getBufferOffset(void) { return 0; };
+
+    void sendCommand(uint8_t command) {
+      panel->command(command);
+      traceCommand(command);
+      countBusTransaction(2);
+    };
+
+    void sendPageSpan(uint8_t page, uint16_t minX, uint16_t maxX) {
+      if (page == transferMinPage) {
+        const int x_offset = (128 - this->width()) / 2;
+        sendCommand(COLUMNADDR);
+        sendCommand(x_offset + minX);
+        sendCommand(x_offset + maxX);
+
+        sendCommand(PAGEADDR);
+        sendCommand(transferMinPage);
+        sendCommand(transferMaxPage);
+      }
+      panel->data(transferFrame + minX + page * this->width(), maxX - minX + 1);
+      countBusTransaction(maxX - minX + 2);
+    };
+
+    OLEDPanelEmulator *panel;
+};
+#endif
+
+#endif
@@ -0,0 +1,681 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+/*
+ * fontconvert - compiles BDF fonts and fonts of the web font tool into font
+ * headers for this library
+ *
+ * Build:  g++ -O2 -o fontconvert fontconvert.cpp
+ * Usage:  fontconvert [OPTIONS] FONT [FONT...] > MyFont.h
+ *
+ * FONT is either a BDF file (*.bdf) or FILE[:ARRAY] with ARRAY (the first one
+ * if not given) of a C header as created by http://oleddisplay.squix.ch.
+ * @BASE after FONT moves its first char to code point BASE, C arrays are taken
+ * to be Latin-1 otherwise (index 0x80 is the Euro sign, like
+ * DefaultFontTableLookup()). Several fonts are merged, they need the same
+ * height.
+ *
+ *   --name NAME      name of the array, "Font" by default
+ *   --subset RANGES  keep only these code points, e.g. 0x20-0x7E,0xB0,0x400-0x45F
+ *   --text FILE      keep only the code points used in the UTF-8 text of FILE
+ *   --dense          write the format indexed by code - first char instead of
+ *                    the sparse format with code point ranges
+ *   --rle            compress the glyph data (see FONT_RLE)
+ *   --metrics        store advance and left bearing of every glyph and crop
+ *                    the bitmaps to their pixels (see FONT_METRICS)
+ *   --kerning FILE   kerning pairs, implies --metrics. Every line has a left
+ *                    char, a right char and the adjustment in pixels, e.g.
+ *                    "A V -1". Chars are UTF-8 or written as U+0020.
+ *
+ * --subset and --text can be given several times, a code point is kept if any
+ * of them has it. Control characters and empty glyphs of width 0 are dropped,
+ * trailing empty bytes of a glyph are cut and glyphs with the same bitmap share
+ * their data.
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Layout, see OLEDDisplay.h
+#define JUMPTABLE_BYTES 4
+#define JUMPTABLE_START 4
+#define FONT_SPARSE     0xFFFF
+#define FONT_RLE        0x8000
+#define FONT_METRICS    0x4000
+
+struct Glyph {
+  uint32_t code;
+  uint16_t width;     // advance
+  int16_t  bearing;   // column of the first byte of data, from the cursor
+  bool     drawable;
+  std::vector<uint16_t> data;
+};
+
+struct KerningPair {
+  uint32_t left;
+  uint32_t right;
+  int16_t  adjustment;
+};
+
+struct Font {
+  uint16_t width;
+  uint16_t height;
+  std::vector<Glyph> glyphs;
+};
+
+static bool readFile(const std::string &name, std::string &content) {
+  FILE *in = fopen(name.c_str(), "rb");
+  if (!in) return false;
+  char block[4096];
+  size_t length;
+  while ((length = fread(block, 1, sizeof(block), in)) > 0) content.append(block, length);
+  fclose(in);
+  return true;
+}
+
+static bool isControl(uint32_t code) {
+  return code < 0x20 || (code >= 0x7F && code < 0xA0);
+}
+
+// Numbers between the braces of the array, comments skipped
+static bool readArray(const std::string &content, const std::string &array, std::vector<uint32_t> &values) {
+  size_t position = array.empty() ? content.find("[]") : content.find(array + "[");
+  if (position == std::string::npos) return false;
+  position = content.find('{', position);
+  if (position == std::string::npos) return false;
+
+  for (size_t i = position + 1; i < content.size(); ) {
+    char c = content[i];
+    if (c == '}') return true;
+    if (content.compare(i, 2, "//") == 0) {
+      i = content.find('\n', i);
+      if (i == std::string::npos) return false;
+    } else if (content.compare(i, 2, "/*") == 0) {
+      i = content.find("*/", i);
+      if (i == std::string::npos) return false;
+      i += 2;
+    } else if (isdigit((unsigned char) c)) {
+      char *end;
+      values.push_back(strtoul(content.c_str() + i, &end, 0));
+      i = end - content.c_str();
+    } else {
+      i++;
+    }
+  }
+  return false;
+}
+
+static bool loadArray(const std::string &file, const std::string &array, bool latin1, uint32_t base, Font &font) {
+  std::string content;
+  std::vector<uint32_t> values;
+  if (!readFile(file, content)) {
+    fprintf(stderr, "Can't read %s\n", file.c_str());
+    return false;
+  }
+  if (!readArray(content, array, values) || values.size() < JUMPTABLE_START) {
+    fprintf(stderr, "No font array %s in %s\n", array.c_str(), file.c_str());
+    return false;
+  }
+
+  uint32_t firstChar = values[2];
+  uint32_t numChars = values[3];
+  size_t   dataStart = JUMPTABLE_START + numChars * JUMPTABLE_BYTES;
+  if (firstChar == FONT_SPARSE || (values[0] & FONT_RLE) || values.size() < dataStart) {
+    fprintf(stderr, "%s %s is not an uncompressed font of the dense format\n", file.c_str(), array.c_str());
+    return false;
+  }
+  font.width = values[0];
+  font.height = values[1];
+  if (latin1) base = firstChar;
+
+  for (uint32_t i = 0; i < numChars; i++) {
+    const uint32_t *entry = &values[JUMPTABLE_START + i * JUMPTABLE_BYTES];
+    Glyph glyph;
+    glyph.code = base + i;
+    glyph.width = entry[3];
+    glyph.bearing = 0;
+    glyph.drawable = !(entry[0] == 0xFF && entry[1] == 0xFF);
+    if (latin1 && glyph.code == 0x80 && glyph.drawable) glyph.code = 0x20AC;
+
+    if (glyph.drawable) {
+      size_t offset = dataStart + ((entry[0] << 8) | entry[1]);
+      if (offset + entry[2] > values.size()) {
+        fprintf(stderr, "%s: data of char %u is out of the array\n", file.c_str(), firstChar + i);
+        return false;
+      }
+      glyph.data.assign(values.begin() + offset, values.begin() + offset + entry[2]);
+    }
+    font.glyphs.push_back(glyph);
+  }
+  return true;
+}
+
+// Renders the bitmaps of a BDF font into columns of 8 pixel high pages
+static bool loadBdf(const std::string &file, uint32_t base, Font &font) {
+  FILE *in = fopen(file.c_str(), "r");
+  if (!in) {
+    fprintf(stderr, "Can't read %s\n", file.c_str());
+    return false;
+  }
+
+  int  ascent = 0, descent = 0, boxHeight = 0, boxY = 0;
+  long encoding = -1;
+  int  advance = 0, w = 0, h = 0, x = 0, y = 0;
+  int  row = -1;
+  std::vector<std::vector<uint8_t> > bitmap;
+  char line[1024];
+
+  font.width = 0;
+  while (fgets(line, sizeof(line), in)) {
+    if (row >= 0) {
+      if (!strncmp(line, "ENDCHAR", 7)) {
+        if (encoding >= 0) {
+          if (!ascent && !descent) {
+            ascent = boxHeight + boxY;
+            descent = -boxY;
+          }
+          font.height = ascent + descent;
+          uint8_t  raster = (font.height + 7) / 8;
+          int      left = std::min(0, x);
+          int      columns = std::max(advance, x + w) - left;
+          Glyph glyph;
+          glyph.code = base + encoding;
+          glyph.width = advance;
+          glyph.bearing = left;
+          glyph.data.assign(columns * raster, 0);
+          for (int r = 0; r < (int) bitmap.size(); r++) {
+            for (int c = 0; c < w; c++) {
+              if (!(bitmap[r][c / 8] & (0x80 >> (c & 7)))) continue;
+              int cellX = x + c - left;
+              int cellY = ascent - (y + h) + r;
+              if (cellX < 0 || cellX >= columns || cellY < 0 || cellY >= font.height) continue;
+              glyph.data[cellX * raster + cellY / 8] |= 1 << (cellY & 7);
+            }
+          }
+          glyph.drawable = true;
+          font.glyphs.push_back(glyph);
+          font.width = std::max(font.width, (uint16_t) advance);
+        }
+        row = -1;
+        continue;
+      }
+      std::vector<uint8_t> bytes;
+      for (char *p = line; isxdigit((unsigned char) p[0]) && isxdigit((unsigned char) p[1]); p += 2) {
+        char hex[3] = {p[0], p[1], 0};
+        bytes.push_back(strtoul(hex, NULL, 16));
+      }
+      bytes.resize((w + 7) / 8, 0);
+      bitmap.push_back(bytes);
+      continue;
+    }
+
+    if (sscanf(line, "FONTBOUNDINGBOX %*d %d %*d %d", &boxHeight, &boxY) == 2) continue;
+    if (sscanf(line, "FONT_ASCENT %d", &ascent) == 1) continue;
+    if (sscanf(line, "FONT_DESCENT %d", &descent) == 1) continue;
+    if (!strncmp(line, "STARTCHAR", 9)) {
+      encoding = -1;
+      advance = w = h = x = y = 0;
+    }
+    sscanf(line, "ENCODING %ld", &encoding);
+    sscanf(line, "DWIDTH %d", &advance);
+    sscanf(line, "BBX %d %d %d %d", &w, &h, &x, &y);
+    if (!strncmp(line, "BITMAP", 6)) {
+      bitmap.clear();
+      row = 0;
+    }
+  }
+  fclose(in);
+
+  if (font.glyphs.empty()) {
+    fprintf(stderr, "No glyphs in %s\n", file.c_str());
+    return false;
+  }
+  return true;
+}
+
+static bool loadFont(const char *argument, Font &font) {
+  std::string spec = argument, array;
+  bool     latin1 = true;
+  uint32_t base = 0;
+
+  size_t at = spec.rfind('@');
+  if (at != std::string::npos) {
+    base = strtoul(spec.c_str() + at + 1, NULL, 0);
+    latin1 = false;
+    spec.erase(at);
+  }
+  if (spec.size() > 4 && !strcasecmp(spec.c_str() + spec.size() - 4, ".bdf")) {
+    return loadBdf(spec, base, font);
+  }
+  size_t colon = spec.rfind(':');
+  if (colon != std::string::npos) {
+    array = spec.substr(colon + 1);
+    spec.erase(colon);
+  }
+  return loadArray(spec, array, latin1, base, font);
+}
+
+// Adds the code points of a list like 0x20-0x7E,0xB0
+static bool parseRanges(const char *list, std::vector<std::pair<uint32_t, uint32_t> > &ranges) {
+  const char *p = list;
+  while (*p) {
+    char *end;
+    uint32_t first = strtoul(p, &end, 0), last = first;
+    if (end == p) return false;
+    p = end;
+    if (*p == '-') {
+      last = strtoul(p + 1, &end, 0);
+      if (end == p + 1) return false;
+      p = end;
+    }
+    ranges.push_back(std::make_pair(first, last));
+    if (*p == ',') p++;
+    else if (*p) return false;
+  }
+  return true;
+}
+
+// Adds the code points used by UTF-8 text
+static bool readText(const char *file, std::set<uint32_t> &codes) {
+  std::string text;
+  if (!readFile(file, text)) return false;
+  for (size_t i = 0; i < text.size(); ) {
+    uint8_t  c = text[i++];
+    uint32_t code = c;
+    int      extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+    if (extra) code = c & (0x3F >> extra);
+    for (; extra > 0 && i < text.size() && (text[i] & 0xC0) == 0x80; extra--) code = (code << 6) | (text[i++] & 0x3F);
+    if (code != '\n' && code != '\r') codes.insert(code);
+  }
+  return true;
+}
+
+// A char of a kerning file: U+0041, 0x41 or the char in UTF-8
+static bool parseChar(const char *token, uint32_t &code) {
+  char *end;
+  if (!strncmp(token, "U+", 2)) {
+    code = strtoul(token + 2, &end, 16);
+    return end != token + 2 && !*end;
+  }
+  if (!strncmp(token, "0x", 2)) {
+    code = strtoul(token, &end, 16);
+    return end != token + 2 && !*end;
+  }
+  const uint8_t *p = (const uint8_t *) token;
+  int extra = p[0] >= 0xF0 ? 3 : p[0] >= 0xE0 ? 2 : p[0] >= 0xC0 ? 1 : 0;
+  code = extra ? p[0] & (0x3F >> extra) : p[0];
+  for (int i = 1; i <= extra; i++) {
+    if ((p[i] & 0xC0) != 0x80) return false;
+    code = (code << 6) | (p[i] & 0x3F);
+  }
+  return p[0] && !p[extra + 1];
+}
+
+static bool readKerning(const char *file, std::vector<KerningPair> &pairs) {
+  FILE *in = fopen(file, "r");
+  if (!in) {
+    fprintf(stderr, "Can't read %s\n", file);
+    return false;
+  }
+  char line[256];
+  int  number = 0;
+  while (fgets(line, sizeof(line), in)) {
+    number++;
+    char left[32], right[32];
+    int  adjustment;
+    if (line[0] == '#' || sscanf(line, "%31s", left) != 1) continue;
+    KerningPair pair;
+    if (sscanf(line, "%31s %31s %d", left, right, &adjustment) != 3 ||
+        !parseChar(left, pair.left) || !parseChar(right, pair.right)) {
+      fprintf(stderr, "%s:%d: expected LEFT RIGHT ADJUSTMENT\n", file, number);
+      fclose(in);
+      return false;
+    }
+    pair.adjustment = adjustment;
+    pairs.push_back(pair);
+  }
+  fclose(in);
+  return true;
+}
+
+// RLE as unpacked by OLEDGlyphDecoder: runs of 3 or more equal bytes are
+// repeated, everything else is copied as literals
+static void compress(const std::vector<uint16_t> &data, std::vector<uint8_t> &out) {
+  size_t i = 0;
+  while (i < data.size()) {
+    size_t run = 1;
+    while (i + run < data.size() && run < 128 && data[i + run] == data[i]) run++;
+    if (run >= 3) {
+      out.push_back(0x80 | (run - 1));
+      out.push_back(data[i]);
+      i += run;
+      continue;
+    }
+    // Literals up to the next run of 3
+    size_t start = i;
+    while (i < data.size() && i - start < 128) {
+      if (i + 2 < data.size() && data[i] == data[i + 1] && data[i] == data[i + 2]) break;
+      i++;
+    }
+    out.push_back(i - start - 1);
+    for (size_t j = start; j < i; j++) out.push_back(data[j]);
+  }
+}
+
+static bool writeFont(const Font &font, const std::string &name, const std::string &sources, bool dense, bool rle,
+    bool metrics, const std::vector<KerningPair> &kerning) {
+  const std::vector<Glyph> &glyphs = font.glyphs;
+  uint8_t raster = (font.height + 7) / 8;
+
+  // Offsets of the glyph data, in bytes of the packed data when compressed.
+  // Glyphs with the same bitmap share it.
+  std::map<std::vector<uint16_t>, uint32_t> shared;
+  std::vector<uint8_t>  packed;
+  std::vector<uint32_t> offsets;
+  std::vector<bool>     first;
+  uint32_t dataSize = 0;
+  for (size_t i = 0; i < glyphs.size(); i++) {
+    std::map<std::vector<uint16_t>, uint32_t>::iterator known = shared.find(glyphs[i].data);
+    first.push_back(known == shared.end());
+    if (known != shared.end()) {
+      offsets.push_back(known->second);
+      continue;
+    }
+    uint32_t offset = rle ? packed.size() : dataSize;
+    shared[glyphs[i].data] = offset;
+    offsets.push_back(offset);
+    if (rle) compress(glyphs[i].data, packed);
+    dataSize += glyphs[i].data.size();
+  }
+  if (rle) dataSize = packed.size();
+  if (dataSize > 0xFFFF) {
+    fprintf(stderr, "A font holds up to 64k bytes of glyph data, this one has %u\n", dataSize);
+    return false;
+  }
+
+  // Dense fonts have an entry for every code between the first and the last
+  uint32_t firstChar = glyphs.front().code;
+  uint32_t numChars = dense ? glyphs.back().code - firstChar + 1 : glyphs.size();
+  if (numChars > 0xFFFF || (dense && glyphs.back().code >= FONT_SPARSE)) {
+    fprintf(stderr, "Too many chars for the %s format: %u\n", dense ? "dense" : "sparse", numChars);
+    return false;
+  }
+
+  // Ranges of consecutive code points: first code point, first glyph
+  std::vector<std::pair<uint32_t, uint32_t> > ranges;
+  for (uint32_t i = 0; i < glyphs.size(); i++) {
+    if (i == 0 || glyphs[i].code != glyphs[i - 1].code + 1) ranges.push_back(std::make_pair(glyphs[i].code, i));
+  }
+
+  // Jump table entry of every code point
+  std::map<uint32_t, uint32_t> entries;
+  for (uint32_t i = 0; i < glyphs.size(); i++) {
+    if (metrics && (glyphs[i].width > 0xFF || glyphs[i].bearing < -128 || glyphs[i].bearing > 127)) {
+      fprintf(stderr, "U+%04X: advance %u or bearing %d don't fit\n", glyphs[i].code, glyphs[i].width, glyphs[i].bearing);
+      return false;
+    }
+    entries[glyphs[i].code] = dense ? glyphs[i].code - firstChar : i;
+  }
+
+  // Kerning pairs by jump table entries, ordered for the binary search
+  std::map<uint32_t, const KerningPair *> pairs;
+  for (size_t i = 0; i < kerning.size(); i++) {
+    uint32_t left = dense && kerning[i].left == 0x20AC ? 0x80 : kerning[i].left;
+    uint32_t right = dense && kerning[i].right == 0x20AC ? 0x80 : kerning[i].right;
+    if (!entries.count(left) || !entries.count(right)) {
+      fprintf(stderr, "Kerning U+%04X U+%04X: the font has no such glyph, skipped\n", kerning[i].left, kerning[i].right);
+      continue;
+    }
+    uint32_t key = (entries[left] << 16) | entries[right];
+    if (!pairs.count(key)) pairs[key] = &kerning[i];
+  }
+
+  printf("// Created by fontconvert from %s\n", sources.c_str());
+  printf("const uint16_t %s[] PROGMEM = {\n", name.c_str());
+  if (rle || metrics) {
+    printf("  0x%04X, // Width: %u%s%s\n", font.width | (rle ? FONT_RLE : 0) | (metrics ? FONT_METRICS : 0),
+      font.width, rle ? ", RLE compressed" : "", metrics ? ", metrics" : "");
+  } else {
+    printf("  0x%02X, // Width: %u\n", font.width, font.width);
+  }
+  printf("  0x%02X, // Height: %u\n", font.height, font.height);
+  if (dense) {
+    printf("  0x%02X, // First Char: %u\n", firstChar, firstChar);
+    printf("  0x%02X, // Numbers of Chars: %u\n", numChars, numChars);
+  } else {
+    printf("  0x%04X, // Sparse font\n", FONT_SPARSE);
+    printf("  0x%02X, // Numbers of Glyphs: %u\n", numChars, numChars);
+
+    printf("  0x%02X, // Numbers of Ranges: %u\n", (unsigned) ranges.size(), (unsigned) ranges.size());
+
+    printf("\n  // Range Table:\n");
+    for (size_t r = 0; r < ranges.size(); r++) {
+      uint32_t code = ranges[r].first;
+      uint32_t glyph = ranges[r].second;
+      uint32_t count = (r + 1 < ranges.size() ? ranges[r + 1].second : glyphs.size()) - glyph;
+      printf("  0x%04X, 0x%04X, 0x%04X, 0x%04X,  // U+%04X..U+%04X\n",
+        code >> 16, code & 0xFFFF, count, glyph, code, code + count - 1);
+    }
+  }
+
+  printf("\n  // Jump Table:\n");
+  size_t next = 0;
+  for (uint32_t code = firstChar; next < glyphs.size(); code++) {
+    bool present = glyphs[next].code == code;
+    if (!dense) code = glyphs[next].code;
+    if (dense && !present) {
+      printf("  0xFF, 0xFF, 0x00, 0x00,  // %u:65535\n", code);
+      continue;
+    }
+    const Glyph &glyph = glyphs[next];
+    uint32_t jump = glyph.drawable ? offsets[next] : 0xFFFF;
+    // With metrics the jump table has the width of the bitmap
+    uint16_t width = metrics ? (glyph.data.size() + raster - 1) / raster : glyph.width;
+    if (dense) {
+      printf("  0x%02X, 0x%02X, 0x%02X, 0x%02X,  // %u:%u\n",
+        jump >> 8, jump & 0xFF, (unsigned) glyph.data.size(), width, code, jump);
+    } else {
+      printf("  0x%02X, 0x%02X, 0x%02X, 0x%02X,  // U+%04X:%u\n",
+        jump >> 8, jump & 0xFF, (unsigned) glyph.data.size(), width, code, jump);
+    }
+    next++;
+  }
+
+  if (metrics) {
+    printf("\n  // Metrics:\n");
+    next = 0;
+    for (uint32_t code = firstChar; next < glyphs.size(); code++) {
+      if (!dense) code = glyphs[next].code;
+      if (glyphs[next].code != code) {
+        printf("  0x0000,  // %u\n", code);
+        continue;
+      }
+      const Glyph &glyph = glyphs[next++];
+      printf(dense ? "  0x%04X,  // %u: advance %u, bearing %d\n" : "  0x%04X,  // U+%04X: advance %u, bearing %d\n",
+        (uint16_t) ((uint8_t) glyph.bearing << 8 | glyph.width), code, glyph.width, glyph.bearing);
+    }
+
+    printf("\n  0x%02X, // Numbers of Kerning Pairs: %u\n", (unsigned) pairs.size(), (unsigned) pairs.size());
+    if (!pairs.empty()) printf("\n  // Kerning Pairs:\n");
+    for (std::map<uint32_t, const KerningPair *>::iterator pair = pairs.begin(); pair != pairs.end(); ++pair) {
+      printf("  0x%04X, 0x%04X, 0x%04X,  // U+%04X U+%04X %d\n", pair->first >> 16, pair->first & 0xFFFF,
+        (uint16_t) pair->second->adjustment, pair->second->left, pair->second->right, pair->second->adjustment);
+    }
+  }
+
+  printf("\n  // Font Data:\n");
+  if (rle) {
+    for (size_t i = 0; i < packed.size(); i += 2) {
+      uint16_t word = packed[i] | (i + 1 < packed.size() ? packed[i + 1] << 8 : 0);
+      printf("%s0x%04X,%s", i % 24 == 0 ? "  " : "", word, i % 24 == 22 || i + 2 >= packed.size() ? "\n" : "");
+    }
+  } else {
+    for (size_t i = 0; i < glyphs.size(); i++) {
+      if (!glyphs[i].drawable || !first[i] || glyphs[i].data.empty()) continue;
+      printf("  ");
+      for (size_t j = 0; j < glyphs[i].data.size(); j++) printf("0x%02X,", glyphs[i].data[j]);
+      printf(dense ? "  // %u\n" : "  // U+%04X\n", glyphs[i].code);
+    }
+  }
+  printf("};\n");
+
+  uint32_t words = (dense ? JUMPTABLE_START : JUMPTABLE_START + 1 + ranges.size() * 4) + numChars * JUMPTABLE_BYTES;
+  if (metrics) words += numChars + 1 + pairs.size() * 3;
+  words += rle ? (dataSize + 1) / 2 : dataSize;
+  fprintf(stderr, "%s: %u glyphs, %u bytes of glyph data, %u bytes of flash\n", name.c_str(),
+    (unsigned) glyphs.size(), dataSize, words * 2);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::string name = "Font", sources;
+  std::vector<std::pair<uint32_t, uint32_t> > subset;
+  std::set<uint32_t> used;
+  std::vector<KerningPair> kerning;
+  bool filter = false, dense = false, rle = false, metrics = false;
+  Font font;
+  font.width = 0;
+  font.height = 0;
+
+  int inputs = 0;
+  bool usage = false;
+  for (int i = 1; i < argc && !usage; i++) {
+    if (!strcmp(argv[i], "--name") && i + 1 < argc) {
+      name = argv[++i];
+    } else if (!strcmp(argv[i], "--subset") && i + 1 < argc) {
+      filter = true;
+      if (!parseRanges(argv[++i], subset)) {
+        fprintf(stderr, "Can't read the code points %s\n", argv[i]);
+        return 2;
+      }
+    } else if (!strcmp(argv[i], "--text") && i + 1 < argc) {
+      filter = true;
+      if (!readText(argv[++i], used)) {
+        fprintf(stderr, "Can't read %s\n", argv[i]);
+        return 1;
+      }
+    } else if (!strcmp(argv[i], "--dense")) {
+      dense = true;
+    } else if (!strcmp(argv[i], "--rle")) {
+      rle = true;
+    } else if (!strcmp(argv[i], "--metrics")) {
+      metrics = true;
+    } else if (!strcmp(argv[i], "--kerning") && i + 1 < argc) {
+      metrics = true;
+      if (!readKerning(argv[++i], kerning)) return 1;
+    } else if (argv[i][0] == '-') {
+      usage = true;
+    } else {
+      Font part;
+      if (!loadFont(argv[i], part)) return 1;
+      if (inputs && part.height != font.height) {
+        fprintf(stderr, "%s has height %u, the other fonts %u\n", argv[i], part.height, font.height);
+        return 1;
+      }
+      font.height = part.height;
+      font.width = std::max(font.width, part.width);
+      font.glyphs.insert(font.glyphs.end(), part.glyphs.begin(), part.glyphs.end());
+      sources += (inputs++ ? ", " : "") + std::string(argv[i]);
+    }
+  }
+  if (usage || !inputs) {
+    fprintf(stderr, "Usage: %s [--name NAME] [--subset RANGES] [--text FILE] [--dense] [--rle] [--metrics] [--kerning FILE] FONT ... > MyFont.h\n", argv[0]);
+    return 2;
+  }
+
+  // Order by code point, the first font given wins for duplicates
+  std::stable_sort(font.glyphs.begin(), font.glyphs.end(),
+    [](const Glyph &a, const Glyph &b) { return a.code < b.code; });
+
+  std::vector<Glyph> glyphs;
+  for (size_t i = 0; i < font.glyphs.size(); i++) {
+    Glyph &glyph = font.glyphs[i];
+    if (!glyphs.empty() && glyphs.back().code == glyph.code) {
+      fprintf(stderr, "U+%04X is in more than one font, keeping the first\n", glyph.code);
+      continue;
+    }
+
+    bool wanted = !filter || used.count(glyph.code);
+    for (size_t r = 0; r < subset.size() && !wanted; r++) {
+      wanted = glyph.code >= subset[r].first && glyph.code <= subset[r].second;
+    }
+    if (!wanted) continue;
+
+    uint8_t raster = (font.height + 7) / 8;
+    if (metrics) {
+      // Empty columns on the left become bearing
+      while (glyph.data.size() >= raster &&
+          std::count(glyph.data.begin(), glyph.data.begin() + raster, 0) == raster) {
+        glyph.data.erase(glyph.data.begin(), glyph.data.begin() + raster);
+        glyph.bearing++;
+      }
+    } else if (glyph.bearing < 0) {
+      // Without metrics bitmaps start at the cursor
+      glyph.data.erase(glyph.data.begin(), glyph.data.begin() + std::min(glyph.data.size(), (size_t) -glyph.bearing * raster));
+      glyph.bearing = 0;
+    } else if (glyph.bearing > 0) {
+      glyph.data.insert(glyph.data.begin(), glyph.bearing * raster, 0);
+      glyph.bearing = 0;
+    }
+
+    // Cut empty bytes at the end, a glyph without pixels is not drawn at all
+    while (!glyph.data.empty() && glyph.data.back() == 0) glyph.data.pop_back();
+    if (glyph.data.empty()) glyph.drawable = false;
+    if (!glyph.drawable) {
+      glyph.data.clear();
+      glyph.bearing = 0;
+    }
+    if (isControl(glyph.code) || (!glyph.drawable && glyph.width == 0)) continue;
+
+    // Dense fonts follow DefaultFontTableLookup(), the Euro sign is at 0x80
+    if (dense && glyph.code == 0x20AC) glyph.code = 0x80;
+    glyphs.push_back(glyph);
+  }
+  if (dense) {
+    std::stable_sort(glyphs.begin(), glyphs.end(),
+      [](const Glyph &a, const Glyph &b) { return a.code < b.code; });
+  }
+  font.glyphs.swap(glyphs);
+
+  if (font.glyphs.empty() || font.glyphs.size() > 0xFFFF) {
+    fprintf(stderr, "A font holds 1 to 65535 glyphs, this one has %u\n", (unsigned) font.glyphs.size());
+    return 1;
+  }
+
+  return writeFont(font, name, sources, dense, rle, metrics, kerning) ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+/*
+ * hostcheck - runs the library on Linux against the panel emulator
+ *
+ * Build:  g++ -O2 -pthread -I../../src -o hostcheck hostcheck.cpp ../emulator/OLEDPanelEmulator.cpp
+ *             ../../src/OLEDDisplay.cpp ../../src/OLEDDisplayPipeline.cpp
+ * Usage:  hostcheck
+ *
+ * Draws frames, sends them directly, through OLEDDisplayPipeline (with and
+ * without swapped buffers) and through OLEDPanelEmulatorSink, and checks the
+ * emulated display RAM holds every frame. Also checks how the emulator wraps
+ * the column in page addressing.
+ * Prints the failed checks and exits with 1 if there are any.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "OLEDDisplay.h"
+#include "OLEDDisplayPipeline.h"
+#include "../emulator/OLEDPanelEmulator.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *what, int step) {
+  if (ok) return;
+  printf("FAIL %s, step %d\n", what, step);
+  failures++;
+}
+
+// Something different on every frame, a moving box and a counter
+static void drawFrame(OLEDDisplay &display, int frame) {
+  display.clear();
+  display.drawRect(frame % 100, (frame * 3) % 40, 28, 24);
+  display.fillRect((frame * 7) % 120, 50, 8, 8);
+  display.drawNumber(0, 0, frame);
+}
+
+static void checkPipeline(const char *name, bool swap) {
+  OLEDPanelEmulator panel(PANEL_SSD1306);
+  OLEDPanelEmulatorDisplay display(&panel);
+  display.init();
+  display.setFont(ArialMT_Plain_10);
+  display.setBufferSwap(swap);
+
+  OLEDDisplayPipeline pipeline(&display);
+  check(pipeline.begin(), name, 0);
+
+  uint8_t expected[128 * 64 / 8];
+  uint8_t strip[200 * 3];
+  for (int frame = 1; frame <= 200; frame++) {
+    drawFrame(display, frame);
+    memcpy(expected, display.buffer, sizeof(expected));
+    pipeline.display();
+    // Drawing the next frame, also off-screen, doesn't touch the frame being sent
+    if (frame % 2) {
+      drawFrame(display, frame + 1000);
+    } else {
+      memset(strip, 0, sizeof(strip));
+      display.setDrawTarget(strip, 200, 20);
+      display.drawString(0, 0, "Drawn off-screen");
+      display.setDrawTarget(NULL);
+      check(strip[0] || strip[1] || strip[2], name, frame);
+    }
+    pipeline.waitIdle();
+    check(!pipeline.isBusy(), name, frame);
+    check(panel.compare(expected) == 0, name, frame);
+  }
+  pipeline.end();
+}
+
+static void checkSink() {
+  OLEDPanelEmulator panel(PANEL_SSD1306);
+  OLEDPanelEmulatorDisplay display(&panel);
+  display.init();
+  display.setFont(ArialMT_Plain_10);
+
+  // Attached after init(), the sink still gets the addressing mode
+  OLEDPanelEmulator traced(PANEL_SSD1306);
+  OLEDPanelEmulatorSink sink(&traced);
+  display.setTraceSink(&sink);
+
+  for (int frame = 1; frame <= 50; frame++) {
+    drawFrame(display, frame);
+    display.display();
+    check(panel.compare(display.buffer) == 0, "display", frame);
+    check(traced.compare(display.buffer) == 0, "trace sink", frame);
+  }
+  display.setTraceSink(NULL);
+}
+
+static void checkPageWrap() {
+  const uint8_t bytes[6] = { 1, 2, 3, 4, 5, 6 };
+
+  // SSD1306: the column wraps to the start address, the page stays
+  OLEDPanelEmulator ssd1306(PANEL_SSD1306);
+  ssd1306.command(0xB3);
+  ssd1306.command(0x0D);
+  ssd1306.command(0x17);
+  ssd1306.data(bytes, 6);
+  check(ssd1306.ramByte(3, 125) == 4 && ssd1306.ramByte(3, 126) == 5 && ssd1306.ramByte(3, 127) == 6, "SSD1306 page addressing", 0);
+  check(ssd1306.ramByte(3, 0) == 0 && ssd1306.ramByte(4, 125) == 0, "SSD1306 page addressing", 1);
+
+  // SH1106: the column stays at the last one
+  OLEDPanelEmulator sh1106(PANEL_SH1106);
+  sh1106.command(0xB3);
+  sh1106.command(0x01);
+  sh1106.command(0x18);
+  sh1106.data(bytes, 4);
+  check(sh1106.ramByte(3, 129) == 1 && sh1106.ramByte(3, 130) == 2 && sh1106.ramByte(3, 131) == 4, "SH1106 page addressing", 0);
+}
+
+int main() {
+  checkSink();
+  checkPageWrap();
+  checkPipeline("pipeline, copied frames", false);
+  checkPipeline("pipeline, swapped buffers", true);
+
+  if (failures) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+  printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 by ThingPulse, Daniel Eichhorn
+ * Copyright (c) 2018 by Fabrice Weinberg
+ * Copyright (c) 2019 by Helmut Tschemernjak - www.radioshuttle.de
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * ThingPulse invests considerable time and money to develop these open source libraries.
+ * Please support us by buying our products (and not the clones) from
+ * https://thingpulse.com
+ *
+ */
+
+/*
+ * oledreplay - rebuilds the display RAM from a capture written by OLEDDisplayCapture
+ *
+ * Build:  g++ -O2 -o oledreplay oledreplay.cpp ../emulator/OLEDPanelEmulator.cpp
+ * Usage:  oledreplay [--sh1106] [--frames PREFIX] [--output FILE.pbm] CAPTURE
+ *
+ * Prints the commands, data bytes, capture bytes and duration of every frame.
+ * --frames writes every frame as PREFIX0000.pbm, PREFIX0001.pbm, ...
+ * --output writes the display content after the last record.
+ * --sh1106 interprets the commands for a SH1106 (page addressing, 132 columns).
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../emulator/OLEDPanelEmulator.h"
+
+static bool readNumber(FILE *in, uint32_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    int byte = fgetc(in);
+    if (byte == EOF) return false;
+    value |= (uint32_t) (byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+static bool writeImage(const std::string &name, const OLEDPanelEmulator &panel, uint16_t width, uint16_t height) {
+  FILE *out = fopen(name.c_str(), "w");
+  if (!out) {
+    fprintf(stderr, "Can't write %s\n", name.c_str());
+    return false;
+  }
+  fprintf(out, "P1\n%u %u\n", width, height);
+  for (uint16_t y = 0; y < height; y++) {
+    for (uint16_t x = 0; x < width; x++) {
+      fputc(panel.ramPixel(x, y) ? '1' : '0', out);
+    }
+    fputc('\n', out);
+  }
+  fclose(out);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  bool sh1106 = false;
+  const char *framePrefix = NULL;
+  const char *output = NULL;
+  const char *input = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--sh1106")) {
+      sh1106 = true;
+    } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+      framePrefix = argv[++i];
+    } else if (!strcmp(argv[i], "--output") && i + 1 < argc) {
+      output = argv[++i];
+    } else if (argv[i][0] != '-' && !input) {
+      input = argv[i];
+    } else {
+      input = NULL;
+      break;
+    }
+  }
+  if (!input) {
+    fprintf(stderr, "Usage: %s [--sh1106] [--frames PREFIX] [--output FILE.pbm] CAPTURE\n", argv[0]);
+    return 2;
+  }
+
+  FILE *in = fopen(input, "rb");
+  if (!in) {
+    fprintf(stderr, "Can't open %s\n", input);
+    return 1;
+  }
+
+  uint8_t header[9];
+  if (fread(header, 1, sizeof(header), in) != sizeof(header) || memcmp(header, "OLED", 4) || header[4] != 1) {
+    fprintf(stderr, "%s is not a version 1 capture\n", input);
+    fclose(in);
+    return 1;
+  }
+  uint16_t width = header[5] | (header[6] << 8);
+  uint16_t height = header[7] | (header[8] << 8);
+  printf("%ux%u %s\n", width, height, sh1106 ? "SH1106" : "SSD1306");
+  printf("frame  commands  data bytes  capture bytes  time (us)\n");
+
+  OLEDPanelEmulator panel(sh1106 ? PANEL_SH1106 : PANEL_SSD1306, width, height);
+  std::vector<uint8_t> bytes;
+  uint32_t frames = 0, commands = 0, dataBytes = 0, time = 0;
+  uint32_t totalCommands = 0, totalData = 0, totalTime = 0;
+  long frameStart = ftell(in);
+  bool truncated = false;
+
+  int type;
+  while ((type = fgetc(in)) != EOF) {
+    uint32_t delta, length;
+    if (!readNumber(in, delta)) { truncated = true; break; }
+    time += delta;
+    if (type == 1) {
+      int command = fgetc(in);
+      if (command == EOF) { truncated = true; break; }
+      panel.command(command);
+      commands++;
+    } else if (type == 2) {
+      if (!readNumber(in, length)) { truncated = true; break; }
+      bytes.resize(length);
+      if (fread(bytes.data(), 1, length, in) != length) { truncated = true; break; }
+      panel.data(bytes.data(), length);
+      dataBytes += length;
+    } else if (type == 3) {
+      long position = ftell(in);
+      printf("%5u  %8u  %10u  %13ld  %9u\n", frames, commands, dataBytes, position - frameStart, time);
+      if (framePrefix) {
+        char name[16];
+        snprintf(name, sizeof(name), "%04u.pbm", frames);
+        writeImage(std::string(framePrefix) + name, panel, width, height);
+      }
+      totalCommands += commands;
+      totalData += dataBytes;
+      totalTime += time;
+      frames++;
+      commands = dataBytes = time = 0;
+      frameStart = position;
+    } else {
+      fprintf(stderr, "Unknown record type %d\n", type);
+      truncated = true;
+      break;
+    }
+  }
+  fclose(in);
+
+  if (truncated) fprintf(stderr, "Capture is truncated or damaged, stopped early\n");
+  printf("%u frames, %u commands, %u data bytes, %u us\n", frames,
+    totalCommands + commands, totalData + dataBytes, totalTime + time);
+
+  if (output && !writeImage(output, panel, width, height)) return 1;
+  return truncated ? 1 : 0;
+}